@@ -0,0 +1,152 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "perf_counters.hpp"
+
+// Minimal benchmark harness: benchmarks register themselves with BENCHMARK
+// and time their variants with state::run.
+namespace bench {
+
+// Keeps the compiler from optimizing away the computation of v.
+template <class T>
+inline void do_not_optimize(T const& v) {
+  asm volatile("" : : "r,m"(v) : "memory");
+}
+
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+// A named numeric parameter of a measurement, e.g. the call depth of a sweep.
+using param = std::pair<char const*, double>;
+
+struct result {
+  std::string benchmark;
+  std::string label;
+  std::vector<param> params;
+  double ns_per_op;
+};
+
+// Every measurement taken, for the runner to write out as JSON.
+inline auto results() -> std::vector<result>& {
+  static std::vector<result> r;
+  return r;
+}
+
+class state {
+ public:
+  explicit state(std::string_view benchmark) : name(benchmark) {}
+
+  // Calls f, which performs ops operations per call, until enough time has
+  // passed and reports the mean time per operation, along with the available
+  // performance counters per operation.
+  template <class F>
+  void run(std::string_view label, std::size_t ops, F&& f,
+           std::vector<param> params = {}) {
+    using clock = std::chrono::steady_clock;
+    constexpr auto min_time = std::chrono::milliseconds(200);
+    auto& perf = counters();
+    f();
+    std::size_t reps = 1;
+    while (true) {
+      perf.start();
+      auto start = clock::now();
+      for (std::size_t i = 0; i < reps; ++i) {
+        f();
+      }
+      auto elapsed = clock::now() - start;
+      perf.stop();
+      if (elapsed >= min_time) {
+        auto const total = static_cast<double>(reps * ops);
+        auto const counts = perf.read();
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+          if (counts[i]) {
+            params.emplace_back(perf_counters::name(i), *counts[i] / total);
+          }
+        }
+        report(label,
+               std::chrono::duration<double, std::nano>(elapsed).count() /
+                   total,
+               std::move(params));
+        return;
+      }
+      reps *= 2;
+    }
+  }
+
+  // Reports a mean time per operation measured by the benchmark itself.
+  void report(std::string_view label, double ns_per_op,
+              std::vector<param> params = {}) {
+    std::printf("%-48.*s %-28.*s %12.2f ns/op",
+                static_cast<int>(name.size()), name.data(),
+                static_cast<int>(label.size()), label.data(), ns_per_op);
+    for (auto const& [key, value] : params) {
+      std::printf("  %s=%g", key, value);
+    }
+    std::printf("\n");
+    results().push_back(
+        {std::string(name), std::string(label), std::move(params), ns_per_op});
+  }
+
+ private:
+  std::string_view name;
+};
+
+using benchmark_fn = void (*)(state&);
+
+struct entry {
+  char const* name;
+  benchmark_fn fn;
+};
+
+inline auto registry() -> std::vector<entry>& {
+  static std::vector<entry> entries;
+  return entries;
+}
+
+struct registrar {
+  registrar(char const* name, benchmark_fn fn) {
+    registry().push_back({name, fn});
+  }
+};
+
+}  // namespace bench
+
+#define BENCH_CONCAT_IMPL(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_IMPL(a, b)
+#define BENCHMARK_IMPL(name, fn)                                  \
+  static void fn(bench::state& state);                            \
+  static bench::registrar const BENCH_CONCAT(fn, _reg){name, fn}; \
+  static void fn(bench::state& state)
+#define BENCHMARK(name) \
+  BENCHMARK_IMPL(name, BENCH_CONCAT(bench_fn_, __COUNTER__))
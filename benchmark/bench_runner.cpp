@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "bench.hpp"
+
+namespace {
+// A JSON string; control characters are written as \u00XX escapes, except
+// for the ones with a short escape.
+void write_escaped(std::FILE* out, std::string_view s) {
+  std::fputc('"', out);
+  for (char c : s) {
+    switch (c) {
+      case '"':
+        std::fputs("\\\"", out);
+        break;
+      case '\\':
+        std::fputs("\\\\", out);
+        break;
+      case '\n':
+        std::fputs("\\n", out);
+        break;
+      case '\r':
+        std::fputs("\\r", out);
+        break;
+      case '\t':
+        std::fputs("\\t", out);
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          std::fprintf(out, "\\u%04x", static_cast<unsigned>(c));
+        } else {
+          std::fputc(c, out);
+        }
+    }
+  }
+  std::fputc('"', out);
+}
+
+// A JSON number, or null for NaN and infinities, which JSON can't represent:
+// a benchmark that ran no iterations has no timing.
+void write_number(std::FILE* out, char const* format, double value) {
+  if (std::isfinite(value)) {
+    std::fprintf(out, format, value);
+  } else {
+    std::fputs("null", out);
+  }
+}
+
+// Writes the results as a JSON array of
+// {"benchmark", "label", "ns_per_op", "params": {name: value}} objects.
+void write_json(std::FILE* out) {
+  std::fputs("[", out);
+  char const* separator = "\n";
+  for (auto const& r : bench::results()) {
+    std::fputs(separator, out);
+    std::fputs("  {\"benchmark\": ", out);
+    write_escaped(out, r.benchmark);
+    std::fputs(", \"label\": ", out);
+    write_escaped(out, r.label);
+    std::fputs(", \"ns_per_op\": ", out);
+    write_number(out, "%.4f", r.ns_per_op);
+    std::fputs(", \"params\": {", out);
+    char const* param_separator = "";
+    for (auto const& [key, value] : r.params) {
+      std::fputs(param_separator, out);
+      write_escaped(out, key);
+      std::fputs(": ", out);
+      write_number(out, "%g", value);
+      param_separator = ", ";
+    }
+    std::fputs("}}", out);
+    separator = ",\n";
+  }
+  std::fputs("\n]\n", out);
+}
+}  // namespace
+
+// usage: expected_benchmarks [filter] [--json <file>]
+//
+// Runs every registered benchmark whose name contains filter, and writes the
+// results to file as JSON if asked to.
+auto main(int argc, char** argv) -> int {
+  char const* filter = "";
+  char const* json = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json = argv[++i];
+    } else {
+      filter = argv[i];
+    }
+  }
+  for (auto const& entry : bench::registry()) {
+    if (std::strstr(entry.name, filter) == nullptr) {
+      continue;
+    }
+    bench::state state(entry.name);
+    entry.fn(state);
+  }
+  if (json != nullptr) {
+    std::FILE* out = std::fopen(json, "w");
+    if (out == nullptr) {
+      std::perror(json);
+      return 1;
+    }
+    write_json(out);
+    std::fclose(out);
+  }
+}
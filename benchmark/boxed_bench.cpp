@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/boxed.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+// An error carrying a message, a context trail and Detail bytes of extra
+// diagnostics.
+template <std::size_t Detail>
+struct rich_error {
+  explicit rich_error(char const* msg) : message(msg) {}
+
+  std::string message;
+  std::vector<std::string> context;
+  std::array<char, Detail> detail{};
+};
+
+template <class E>
+using result = rd::expected<int, E>;
+
+constexpr int layers = 4;
+constexpr std::size_t elements = 4096;
+
+// Fails only for negative inputs, which the benchmarks never pass.
+template <class E>
+[[gnu::noinline]] auto parse(int x) -> result<E> {
+  if (x < 0) {
+    return result<E>(rd::unexpect, "negative input");
+  }
+  return x + 1;
+}
+
+template <class E, int Layer>
+[[gnu::noinline]] auto call(int x) -> result<E> {
+  if constexpr (Layer == 0) {
+    return parse<E>(x);
+  } else {
+    return call<E, Layer - 1>(x).and_then(parse<E>);
+  }
+}
+
+template <class E>
+void call_layers(bench::state& state, std::string const& label) {
+  state.run(label, elements, [] {
+    int sum = 0;
+    for (std::size_t i = 0; i < elements; ++i) {
+      auto r = call<E, layers>(static_cast<int>(i));
+      sum += *r;
+    }
+    bench::do_not_optimize(sum);
+  });
+}
+
+template <class E>
+void store_results(bench::state& state, std::string const& label) {
+  std::vector<result<E>> results;
+  results.reserve(elements);
+  state.run(label, elements, [&] {
+    results.clear();
+    for (std::size_t i = 0; i < elements; ++i) {
+      results.push_back(parse<E>(static_cast<int>(i)));
+    }
+    int sum = 0;
+    for (auto const& r : results) {
+      sum += *r;
+    }
+    bench::do_not_optimize(sum);
+  });
+}
+
+template <std::size_t Detail, class F>
+void inline_vs_boxed(F&& run) {
+  auto const size = std::to_string(sizeof(rich_error<Detail>));
+  run.template operator()<rich_error<Detail>>("inline, " + size + " B error");
+  run.template operator()<rd::boxed<rich_error<Detail>>>("boxed, " + size +
+                                                         " B error");
+}
+
+template <class F>
+void payload_sizes(F&& run) {
+  inline_vs_boxed<16>(run);
+  inline_vs_boxed<64>(run);
+  inline_vs_boxed<256>(run);
+  inline_vs_boxed<1024>(run);
+}
+}  // namespace
+
+BENCHMARK("boxed: success path through call layers") {
+  payload_sizes([&]<class E>(std::string const& label) {
+    call_layers<E>(state, label);
+  });
+}
+
+BENCHMARK("boxed: storing successful results") {
+  payload_sizes([&]<class E>(std::string const& label) {
+    store_results<E>(state, label);
+  });
+}
@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// rd::collect against the hand-written loop it replaces, which pushes back
+// into a vector without reserving, for 1e3 up to 1e7 results of which none
+// fail. Also collects from a lazy range, and from a vector of strings as an
+// lvalue and as an rvalue, where the strings are moved out.
+
+#include <cstddef>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/collect.hpp"
+
+namespace {
+using result = rd::expected<int, int>;
+
+auto parse(int i) -> result {
+  if (i < 0) [[unlikely]] {
+    return rd::unexpected(i);
+  }
+  return i;
+}
+
+auto hand_written(std::vector<result> const& v)
+    -> rd::expected<std::vector<int>, int> {
+  std::vector<int> out;
+  for (auto const& r : v) {
+    if (!r) {
+      return rd::unexpected(r.error());
+    }
+    out.push_back(*r);
+  }
+  return out;
+}
+
+auto sizes() -> std::vector<std::size_t> {
+  return {1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+}
+
+auto size_param(std::size_t n) -> std::vector<bench::param> {
+  return {{"elements", static_cast<double>(n)}};
+}
+}  // namespace
+
+BENCHMARK("collect: vector of expected<int, int>") {
+  for (auto n : sizes()) {
+    std::vector<result> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      v.push_back(parse(static_cast<int>(i)));
+    }
+    state.run(
+        "hand-written loop", n,
+        [&] { bench::do_not_optimize(hand_written(v)->size()); },
+        size_param(n));
+    state.run(
+        "rd::collect", n,
+        [&] {
+          bench::do_not_optimize(rd::collect<std::vector<int>>(v)->size());
+        },
+        size_param(n));
+  }
+}
+
+BENCHMARK("collect: lazy range") {
+  for (auto n : sizes()) {
+    auto lazy = std::views::iota(0, static_cast<int>(n)) |
+                std::views::transform(parse);
+    state.run(
+        "rd::collect", n,
+        [&] {
+          bench::do_not_optimize(rd::collect<std::vector<int>>(lazy)->size());
+        },
+        size_param(n));
+  }
+}
+
+BENCHMARK("collect: vector of strings") {
+  // Strings too long for the small string buffer.
+  std::string const text(32, 's');
+  for (auto n : sizes()) {
+    if (n > 1'000'000) {
+      break;
+    }
+    std::vector<rd::expected<std::string, int>> source(n, text);
+    // Both copy the source first, so the difference is the cost of copying
+    // the strings out instead of moving them.
+    state.run(
+        "copied out", n,
+        [&] {
+          auto copy = source;
+          auto r = rd::collect<std::vector<std::string>>(copy);
+          bench::do_not_optimize(r->size());
+        },
+        size_param(n));
+    state.run(
+        "moved out", n,
+        [&] {
+          auto copy = source;
+          auto r = rd::collect<std::vector<std::string>>(std::move(copy));
+          bench::do_not_optimize(r->size());
+        },
+        size_param(n));
+  }
+}
@@ -0,0 +1,182 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Runs the same error-heavy workload on 1 to N threads, propagating errors
+// with rd::expected and with exceptions. Unwinding takes locks shared by all
+// threads (e.g. in dl_iterate_phdr on glibc), so the exception path stops
+// scaling under contention while expected keeps up.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <latch>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+struct error {
+  int code;
+};
+
+constexpr int depth = 8;
+constexpr std::size_t calls_per_thread = 20000;
+constexpr double failure_rate = 0.1;
+
+template <int Depth>
+[[gnu::noinline]] auto expected_call(int x, bool fail)
+    -> rd::expected<int, error> {
+  if constexpr (Depth == 1) {
+    if (fail) {
+      return rd::unexpected(error{x});
+    }
+    return x;
+  } else {
+    auto r = expected_call<Depth - 1>(x, fail);
+    if (!r) {
+      return rd::unexpected(r.error());
+    }
+    return *r + 1;
+  }
+}
+
+template <int Depth>
+[[gnu::noinline]] auto throwing_call(int x, bool fail) -> int {
+  if constexpr (Depth == 1) {
+    if (fail) {
+      throw error{x};
+    }
+    return x;
+  } else {
+    return throwing_call<Depth - 1>(x, fail) + 1;
+  }
+}
+
+struct with_expected {
+  static constexpr char const* name = "rd::expected";
+
+  static auto call(int x, bool fail) -> int {
+    auto r = expected_call<depth>(x, fail);
+    return r ? *r : r.error().code;
+  }
+};
+
+struct with_exceptions {
+  static constexpr char const* name = "exceptions";
+
+  static auto call(int x, bool fail) -> int {
+    try {
+      return throwing_call<depth>(x, fail);
+    } catch (error const& e) {
+      return e.code;
+    }
+  }
+};
+
+// Times every call of one thread, in nanoseconds.
+template <class M>
+auto run_thread(std::latch& start, unsigned seed) -> std::vector<double> {
+  using clock = std::chrono::steady_clock;
+  std::mt19937 gen(seed);
+  std::bernoulli_distribution fails(failure_rate);
+  std::vector<bool> fail(calls_per_thread);
+  for (std::size_t i = 0; i < calls_per_thread; ++i) {
+    fail[i] = fails(gen);
+  }
+  std::vector<double> latencies(calls_per_thread);
+  start.arrive_and_wait();
+  int sum = 0;
+  for (std::size_t i = 0; i < calls_per_thread; ++i) {
+    auto const before = clock::now();
+    sum += M::call(static_cast<int>(i), fail[i]);
+    latencies[i] =
+        std::chrono::duration<double, std::nano>(clock::now() - before)
+            .count();
+  }
+  bench::do_not_optimize(sum);
+  return latencies;
+}
+
+// Reports the mean time per call and thread, the throughput per thread and
+// the 99th percentile latency of a call.
+template <class M>
+void measure(bench::state& state, unsigned threads) {
+  using clock = std::chrono::steady_clock;
+  std::vector<std::vector<double>> latencies(threads);
+  std::latch start(threads + 1);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      latencies[t] = run_thread<M>(start, 42 + t);  // NOLINT
+    });
+  }
+  start.arrive_and_wait();
+  auto const began = clock::now();
+  for (auto& w : workers) {
+    w.join();
+  }
+  auto const elapsed =
+      std::chrono::duration<double, std::nano>(clock::now() - began).count();
+
+  std::vector<double> all;
+  all.reserve(threads * calls_per_thread);
+  for (auto const& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  auto const p99 = all.begin() + static_cast<std::ptrdiff_t>(
+                                     all.size() * 99 / 100);
+  std::nth_element(all.begin(), p99, all.end());
+
+  auto const ns_per_call = elapsed / static_cast<double>(calls_per_thread);
+  state.report(std::string(M::name) + ", " + std::to_string(threads) +
+                   (threads == 1 ? " thread" : " threads"),
+               ns_per_call,
+               {{"threads", threads},
+                {"calls_per_second_per_thread", 1e9 / ns_per_call},
+                {"p99_ns", *p99}});
+}
+
+auto thread_counts() -> std::vector<unsigned> {
+  unsigned const cores = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned n = 1; n < cores; n *= 2) {
+    counts.push_back(n);
+  }
+  counts.push_back(cores);
+  return counts;
+}
+}  // namespace
+
+BENCHMARK("contention: 10% failures through 8 calls") {
+  for (unsigned threads : thread_counts()) {
+    measure<with_expected>(state, threads);
+    measure<with_exceptions>(state, threads);
+  }
+}
@@ -0,0 +1,132 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/boxed.hpp"
+#include "rd/error_arena.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+// Longer than any small string buffer.
+constexpr std::string_view message = "failed to parse the request header";
+constexpr std::string_view frame = "while handling request on connection";
+
+struct heap_error {
+  explicit heap_error(std::string_view msg) : message(msg) {}
+
+  std::string message;
+  std::vector<std::string> context;
+};
+
+struct pmr_error {
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
+  explicit pmr_error(std::string_view msg,
+                     allocator_type alloc = rd::error_allocator())
+      : message(msg, alloc), context(alloc) {}
+
+  pmr_error(pmr_error&& other, allocator_type alloc)
+      : message(std::move(other.message), alloc),
+        context(std::move(other.context), alloc) {}
+
+  std::pmr::string message;
+  std::pmr::vector<std::pmr::string> context;
+};
+
+constexpr int failures_per_request = 8;
+constexpr int context_frames = 3;
+
+template <class E>
+[[gnu::noinline]] auto parse(int x) -> rd::expected<int, E> {
+  if (x >= 0) {
+    return rd::unexpected(E(message));
+  }
+  return x;
+}
+
+template <class E>
+auto get(E& e) -> E& {
+  return e;
+}
+
+template <class E>
+auto get(rd::boxed<E>& e) -> E& {
+  return *e;
+}
+
+// Every call fails, and the error collects a few frames of context.
+template <class E>
+auto handle_request(int id) -> std::size_t {
+  std::size_t total = 0;
+  for (int i = 0; i < failures_per_request; ++i) {
+    auto r = parse<E>(id + i);
+    if (!r) {
+      auto& e = get(r.error());
+      for (int j = 0; j < context_frames; ++j) {
+        e.context.emplace_back(frame);
+      }
+      total += e.message.size() + e.context.size();
+    }
+  }
+  return total;
+}
+
+template <class E>
+void without_arena(bench::state& state, std::string_view label) {
+  state.run(label, 1, [] { bench::do_not_optimize(handle_request<E>(0)); });
+}
+
+template <class E>
+void heap_arena(bench::state& state, std::string_view label) {
+  state.run(label, 1, [] {
+    rd::error_arena arena;
+    bench::do_not_optimize(handle_request<E>(0));
+  });
+}
+
+template <class E>
+void stack_arena(bench::state& state, std::string_view label) {
+  state.run(label, 1, [] {
+    alignas(std::max_align_t) std::byte buffer[8192];
+    rd::error_arena arena(buffer, sizeof(buffer));
+    bench::do_not_optimize(handle_request<E>(0));
+  });
+}
+}  // namespace
+
+BENCHMARK("error_arena: requests failing 8 times") {
+  without_arena<heap_error>(state, "global new");
+  without_arena<rd::boxed<heap_error>>(state, "global new, boxed");
+  heap_arena<pmr_error>(state, "error_arena");
+  heap_arena<rd::boxed<pmr_error>>(state, "error_arena, boxed");
+  stack_arena<pmr_error>(state, "error_arena on stack");
+  stack_arena<rd::boxed<pmr_error>>(state, "error_arena on stack, boxed");
+}
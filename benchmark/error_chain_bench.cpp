@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include "bench.hpp"
+#include "rd/error_chain.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+constexpr std::size_t elements = 4096;
+
+// Each layer adds a frame of context to errors coming from below: either a
+// static frame on an error_chain, or by concatenating onto a string error.
+using chain = rd::error_chain<std::errc>;
+
+[[gnu::noinline]] auto parse_chain(int x) -> rd::expected<int, chain> {
+  if (x < 0) {
+    return rd::unexpected(std::errc::invalid_argument);
+  }
+  return x + 1;
+}
+
+[[gnu::noinline]] auto parse_string(int x) -> rd::expected<int, std::string> {
+  if (x < 0) {
+    return rd::unexpected(
+        std::make_error_code(std::errc::invalid_argument).message());
+  }
+  return x + 1;
+}
+
+template <int Layer>
+[[gnu::noinline]] auto call_chain(int x) -> rd::expected<int, chain> {
+  if constexpr (Layer == 0) {
+    return parse_chain(x);
+  } else {
+    return call_chain<Layer - 1>(x).context("while handling a layer");
+  }
+}
+
+template <int Layer>
+[[gnu::noinline]] auto call_string(int x) -> rd::expected<int, std::string> {
+  if constexpr (Layer == 0) {
+    return parse_string(x);
+  } else {
+    return call_string<Layer - 1>(x).transform_error([](std::string&& e) {
+      return "while handling a layer: " + std::move(e);
+    });
+  }
+}
+
+template <class F>
+void propagate(bench::state& state, std::string const& label, int sign,
+               F call) {
+  state.run(label, elements, [&] {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < elements; ++i) {
+      auto r = call(sign * static_cast<int>(i + 1));
+      sum += r ? static_cast<std::size_t>(*r) : r.error().size();
+    }
+    bench::do_not_optimize(sum);
+  });
+}
+}  // namespace
+
+BENCHMARK("error_chain: 6 layers of context, failure path") {
+  propagate(state, "error_chain, static frames", -1, call_chain<6>);
+  propagate(state, "string concatenation", -1, call_string<6>);
+}
+
+BENCHMARK("error_chain: 6 layers of context, success path") {
+  propagate(state, "error_chain, static frames", 1, call_chain<6>);
+  propagate(state, "string concatenation", 1, call_string<6>);
+}
+
+BENCHMARK("error_chain: rendering a 6 frame chain") {
+  auto e = call_chain<6>(-1);
+  state.run("message()", 1, [&] {
+    auto message = e.error().message();
+    bench::do_not_optimize(message);
+  });
+}
@@ -0,0 +1,292 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Compares ways of reporting errors through a chain of calls: rd::expected,
+// std::expected (when available), exceptions, std::error_code out-parameters
+// and std::variant. Each sweep varies one of failure rate, call depth,
+// payload size and error size, keeping the others at their defaults.
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+#include "bench.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+// The result of a successful call, Size bytes.
+template <std::size_t Size>
+struct payload {
+  explicit payload(int v) : value(v) {}
+
+  int value;
+  std::array<char, Size - sizeof(int)> rest{};
+};
+
+// The error of a failed call, Size bytes.
+template <std::size_t Size>
+struct error {
+  explicit error(int c) : code(c) {}
+
+  int code;
+  std::array<char, Size - sizeof(int)> rest{};
+};
+
+// Layers on the way up add one to the value, so that they do some work on
+// success.
+struct rd_expected {
+  static constexpr char const* name = "rd::expected";
+
+  template <class P, class E, int Depth>
+  [[gnu::noinline]] static auto call(int x, bool fail) -> rd::expected<P, E> {
+    if constexpr (Depth == 1) {
+      if (fail) {
+        return rd::unexpected(E(x));
+      }
+      return P(x);
+    } else {
+      auto r = call<P, E, Depth - 1>(x, fail);
+      if (!r) {
+        return rd::unexpected(std::move(r).error());
+      }
+      ++r->value;
+      return r;
+    }
+  }
+
+  template <class P, class E, int Depth>
+  static auto run(int x, bool fail) -> int {
+    auto r = call<P, E, Depth>(x, fail);
+    return r ? r->value : r.error().code;
+  }
+};
+
+#if defined(__cpp_lib_expected)
+struct std_expected {
+  static constexpr char const* name = "std::expected";
+
+  template <class P, class E, int Depth>
+  [[gnu::noinline]] static auto call(int x, bool fail) -> std::expected<P, E> {
+    if constexpr (Depth == 1) {
+      if (fail) {
+        return std::unexpected(E(x));
+      }
+      return P(x);
+    } else {
+      auto r = call<P, E, Depth - 1>(x, fail);
+      if (!r) {
+        return std::unexpected(std::move(r).error());
+      }
+      ++r->value;
+      return r;
+    }
+  }
+
+  template <class P, class E, int Depth>
+  static auto run(int x, bool fail) -> int {
+    auto r = call<P, E, Depth>(x, fail);
+    return r ? r->value : r.error().code;
+  }
+};
+#endif
+
+struct exceptions {
+  static constexpr char const* name = "exceptions";
+
+  template <class P, class E, int Depth>
+  [[gnu::noinline]] static auto call(int x, bool fail) -> P {
+    if constexpr (Depth == 1) {
+      if (fail) {
+        throw E(x);
+      }
+      return P(x);
+    } else {
+      auto r = call<P, E, Depth - 1>(x, fail);
+      ++r.value;
+      return r;
+    }
+  }
+
+  template <class P, class E, int Depth>
+  static auto run(int x, bool fail) -> int {
+    try {
+      return call<P, E, Depth>(x, fail).value;
+    } catch (E const& e) {
+      return e.code;
+    }
+  }
+};
+
+// The error is always a std::error_code; E is ignored.
+struct error_code {
+  static constexpr char const* name = "std::error_code";
+
+  template <class P, class E, int Depth>
+  [[gnu::noinline]] static auto call(int x, bool fail, std::error_code& ec)
+      -> P {
+    if constexpr (Depth == 1) {
+      if (fail) {
+        ec.assign(x, std::generic_category());
+        return P(0);
+      }
+      return P(x);
+    } else {
+      auto r = call<P, E, Depth - 1>(x, fail, ec);
+      if (ec) {
+        return r;
+      }
+      ++r.value;
+      return r;
+    }
+  }
+
+  template <class P, class E, int Depth>
+  static auto run(int x, bool fail) -> int {
+    std::error_code ec;
+    auto r = call<P, E, Depth>(x, fail, ec);
+    return ec ? ec.value() : r.value;
+  }
+};
+
+struct variant {
+  static constexpr char const* name = "std::variant";
+
+  template <class P, class E, int Depth>
+  [[gnu::noinline]] static auto call(int x, bool fail) -> std::variant<P, E> {
+    if constexpr (Depth == 1) {
+      if (fail) {
+        return E(x);
+      }
+      return P(x);
+    } else {
+      auto r = call<P, E, Depth - 1>(x, fail);
+      if (auto* p = std::get_if<P>(&r)) {
+        ++p->value;
+      }
+      return r;
+    }
+  }
+
+  template <class P, class E, int Depth>
+  static auto run(int x, bool fail) -> int {
+    auto r = call<P, E, Depth>(x, fail);
+    if (auto const* p = std::get_if<P>(&r)) {
+      return p->value;
+    }
+    return std::get<E>(r).code;
+  }
+};
+
+constexpr std::size_t calls = 10000;
+
+// Which of the calls fail, at random with the given rate.
+auto failures(double rate) -> std::vector<bool> {
+  std::mt19937 gen(42);  // NOLINT
+  std::bernoulli_distribution fails(rate);
+  std::vector<bool> r(calls);
+  for (std::size_t i = 0; i < calls; ++i) {
+    r[i] = fails(gen);
+  }
+  return r;
+}
+
+template <class M, std::size_t Payload, std::size_t Error, int Depth>
+void measure(bench::state& state, double rate) {
+  auto const fail = failures(rate);
+  state.run(
+      M::name, calls,
+      [&] {
+        int sum = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+          sum += M::template run<payload<Payload>, error<Error>, Depth>(
+              static_cast<int>(i), fail[i]);
+        }
+        bench::do_not_optimize(sum);
+      },
+      {{"failure_rate", rate},
+       {"depth", Depth},
+       {"payload_size", Payload},
+       {"error_size", Error}});
+}
+
+template <std::size_t Payload, std::size_t Error, int Depth>
+void mechanisms(bench::state& state, double rate, bool with_error_code) {
+  measure<rd_expected, Payload, Error, Depth>(state, rate);
+#if defined(__cpp_lib_expected)
+  measure<std_expected, Payload, Error, Depth>(state, rate);
+#endif
+  measure<exceptions, Payload, Error, Depth>(state, rate);
+  if (with_error_code) {
+    measure<error_code, Payload, Error, Depth>(state, rate);
+  }
+  measure<variant, Payload, Error, Depth>(state, rate);
+}
+
+constexpr std::size_t default_payload = 8;
+constexpr std::size_t default_error = 8;
+constexpr int default_depth = 8;
+constexpr double default_rate = 0.01;
+}  // namespace
+
+BENCHMARK("error handling: failure rate") {
+  for (double rate : {0.0, 0.001, 0.01, 0.1, 0.5}) {
+    mechanisms<default_payload, default_error, default_depth>(state, rate,
+                                                              true);
+  }
+}
+
+BENCHMARK("error handling: call depth") {
+  [&]<int... Depth>(std::integer_sequence<int, Depth...>) {
+    (mechanisms<default_payload, default_error, Depth>(state, default_rate,
+                                                       true),
+     ...);
+  }(std::integer_sequence<int, 1, 2, 4, 8, 16, 32>{});
+}
+
+BENCHMARK("error handling: payload size") {
+  [&]<std::size_t... Payload>(std::index_sequence<Payload...>) {
+    (mechanisms<Payload, default_error, default_depth>(state, default_rate,
+                                                       true),
+     ...);
+  }(std::index_sequence<8, 64, 256>{});
+}
+
+// The error code out-parameter can't carry a larger error.
+BENCHMARK("error handling: error size") {
+  [&]<std::size_t... Error>(std::index_sequence<Error...>) {
+    (mechanisms<default_payload, Error, default_depth>(state, default_rate,
+                                                       false),
+     ...);
+  }(std::index_sequence<8, 64, 256>{});
+}
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Observer accesses, compiled in each hardening mode by the hardening_*
+// benchmarks. Each mode has its own inline namespace, so the expected members
+// instantiated in different modes don't clash.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+namespace hardening {
+struct value {
+  int v;
+  int pad;
+};
+
+struct error {
+  int code;
+};
+
+constexpr std::size_t elements = 4096;
+
+[[gnu::noinline]] auto results(bool failed)
+    -> std::vector<rd::expected<value, error>> {
+  std::vector<rd::expected<value, error>> r;
+  r.reserve(elements);
+  for (std::size_t i = 0; i < elements; ++i) {
+    if (failed) {
+      r.emplace_back(rd::unexpect, error{static_cast<int>(i)});
+    } else {
+      r.emplace_back(value{static_cast<int>(i), 0});
+    }
+  }
+  return r;
+}
+
+void observers(bench::state& state, std::string const& mode) {
+  auto const values = results(false);
+  auto const errors = results(true);
+
+  state.run(mode + ", operator*", elements, [&] {
+    int sum = 0;
+    for (auto const& r : values) {
+      sum += (*r).v;
+    }
+    bench::do_not_optimize(sum);
+  });
+
+  state.run(mode + ", operator->", elements, [&] {
+    int sum = 0;
+    for (auto const& r : values) {
+      sum += r->v;
+    }
+    bench::do_not_optimize(sum);
+  });
+
+  state.run(mode + ", error()", elements, [&] {
+    int sum = 0;
+    for (auto const& r : errors) {
+      sum += r.error().code;
+    }
+    bench::do_not_optimize(sum);
+  });
+
+  // A single access through an opaque pointer, as in code that isn't a loop.
+  auto const* single = &values.front();
+  state.run(mode + ", single access", 1, [&] {
+    bench::do_not_optimize(single);
+    int const v = (*single)->v;
+    bench::do_not_optimize(v);
+  });
+}
+}  // namespace hardening
+}  // namespace
@@ -0,0 +1,54 @@
+# MIT License
+# 
+# Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Builds the header_consumers and module_consumers targets from clean and
+# reports how long each took. The module's time includes building the
+# module itself. Run on a build tree configured with
+# -DENABLE_BENCHMARKS=ON -DENABLE_MODULES=ON as
+#   cmake -DBUILD_DIR=<build dir> -P compare_build_times.cmake
+
+if(NOT BUILD_DIR)
+  message(FATAL_ERROR "pass the build directory as -DBUILD_DIR=<dir>")
+endif()
+
+# Builds target from clean and stores how long it took in out, in ms.
+function(time_build target out)
+  execute_process(COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --target clean
+                  OUTPUT_QUIET)
+  string(TIMESTAMP start "%s%f")
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --target ${target}
+    RESULT_VARIABLE result
+    OUTPUT_QUIET)
+  string(TIMESTAMP stop "%s%f")
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "building ${target} failed")
+  endif()
+  math(EXPR elapsed "(${stop} - ${start}) / 1000")
+  set(${out} ${elapsed} PARENT_SCOPE)
+endfunction()
+
+time_build(header_consumers header)
+time_build(module_consumers module)
+message(STATUS "#include \"rd/expected.hpp\": ${header} ms")
+message(STATUS "import rd.expected:          ${module} ms")
@@ -0,0 +1,194 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Each member family of expected against the hand-written if code it
+// replaces, over results of which 10% are errors. Where the performance
+// counters are available they tell why one is slower than the other.
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+struct error {
+  int code;
+};
+
+using result = rd::expected<int, error>;
+
+constexpr std::size_t elements = 4096;
+
+auto make_results(double failure_rate) -> std::vector<result> {
+  std::mt19937 gen(42);  // NOLINT
+  std::bernoulli_distribution fails(failure_rate);
+  std::vector<result> r;
+  r.reserve(elements);
+  for (std::size_t i = 0; i < elements; ++i) {
+    if (fails(gen)) {
+      r.emplace_back(rd::unexpect, error{static_cast<int>(i)});
+    } else {
+      r.emplace_back(static_cast<int>(i));
+    }
+  }
+  return r;
+}
+
+auto half(int x) -> result {
+  if (x % 7 == 0) {
+    return rd::unexpected(error{x});
+  }
+  return x / 2;
+}
+
+auto recover(error e) -> result { return e.code % 3; }
+
+auto consume(result const& r) -> int { return r ? *r : r.error().code; }
+
+// Runs op on every result, as a member and as hand-written code.
+template <class Member, class Manual>
+void compare(bench::state& state, std::string const& family, Member member,
+             Manual manual) {
+  auto const results = make_results(0.1);
+  state.run(family, elements, [&] {
+    int sum = 0;
+    for (auto const& r : results) {
+      sum += member(r);
+    }
+    bench::do_not_optimize(sum);
+  });
+  state.run("hand-written if", elements, [&] {
+    int sum = 0;
+    for (auto const& r : results) {
+      sum += manual(r);
+    }
+    bench::do_not_optimize(sum);
+  });
+}
+
+enum class state_of { value, error };
+
+auto make(state_of s, int i) -> result {
+  if (s == state_of::value) {
+    return i;
+  }
+  return rd::unexpected(error{i});
+}
+
+auto name(state_of s) -> char const* {
+  return s == state_of::value ? "value" : "error";
+}
+
+// Assigns results in state from to results in state to.
+void assign(bench::state& state, state_of to, state_of from) {
+  std::vector<result> targets;
+  std::vector<result> sources;
+  for (std::size_t i = 0; i < elements; ++i) {
+    targets.push_back(make(to, static_cast<int>(i)));
+    sources.push_back(make(from, static_cast<int>(i)));
+  }
+  state.run(std::string(name(to)) + " = " + name(from), elements, [&] {
+    for (std::size_t i = 0; i < elements; ++i) {
+      targets[i] = sources[i];
+    }
+    bench::clobber_memory();
+    // Restore the state assigned over.
+    for (std::size_t i = 0; i < elements; ++i) {
+      targets[i] = make(to, static_cast<int>(i));
+    }
+    bench::clobber_memory();
+  });
+}
+}  // namespace
+
+BENCHMARK("monadic: and_then") {
+  compare(
+      state, "and_then",
+      [](result const& r) { return consume(r.and_then(half)); },
+      [](result const& r) {
+        if (!r) {
+          return r.error().code;
+        }
+        return consume(half(*r));
+      });
+}
+
+BENCHMARK("monadic: or_else") {
+  compare(
+      state, "or_else",
+      [](result const& r) { return consume(r.or_else(recover)); },
+      [](result const& r) {
+        if (r) {
+          return *r;
+        }
+        return consume(recover(r.error()));
+      });
+}
+
+BENCHMARK("monadic: transform") {
+  compare(
+      state, "transform",
+      [](result const& r) {
+        return consume(r.transform([](int x) { return x * 3; }));
+      },
+      [](result const& r) { return r ? *r * 3 : r.error().code; });
+}
+
+BENCHMARK("monadic: transform_error") {
+  compare(
+      state, "transform_error",
+      [](result const& r) {
+        auto t = r.transform_error([](error e) { return error{e.code + 1}; });
+        return consume(t);
+      },
+      [](result const& r) { return r ? *r : r.error().code + 1; });
+}
+
+BENCHMARK("monadic: value_or") {
+  compare(
+      state, "value_or", [](result const& r) { return r.value_or(0); },
+      [](result const& r) { return r ? *r : 0; });
+}
+
+BENCHMARK("monadic: swap") {
+  auto results = make_results(0.5);
+  state.run("swap neighbours", elements - 1, [&] {
+    for (std::size_t i = 0; i + 1 < elements; ++i) {
+      results[i].swap(results[i + 1]);
+    }
+    bench::clobber_memory();
+  });
+}
+
+BENCHMARK("monadic: assignment") {
+  for (auto to : {state_of::value, state_of::error}) {
+    for (auto from : {state_of::value, state_of::error}) {
+      assign(state, to, from);
+    }
+  }
+}
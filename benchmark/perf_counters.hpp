@@ -0,0 +1,186 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters of the calling thread, read with
+// perf_event_open on Linux. Counters the kernel or the CPU don't provide are
+// left out; elsewhere none are available and benchmarks only report timings.
+namespace bench {
+
+class perf_counters {
+ public:
+  struct counter {
+    char const* name;
+    std::uint32_t type;
+    std::uint64_t config;
+  };
+
+  static constexpr std::size_t count = 5;
+
+  perf_counters() {
+#if defined(__linux__)
+    for (std::size_t i = 0; i < count; ++i) {
+      fds[i] = open(events[i]);
+    }
+#endif
+  }
+
+  perf_counters(perf_counters const&) = delete;
+  auto operator=(perf_counters const&) -> perf_counters& = delete;
+
+  ~perf_counters() {
+#if defined(__linux__)
+    for (int fd : fds) {
+      if (fd != -1) {
+        ::close(fd);
+      }
+    }
+#endif
+  }
+
+  [[nodiscard]] auto available() const -> bool {
+    for (int fd : fds) {
+      if (fd != -1) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void start() {
+#if defined(__linux__)
+    for (int fd : fds) {
+      if (fd != -1) {
+        ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  void stop() {
+#if defined(__linux__)
+    for (int fd : fds) {
+      if (fd != -1) {
+        ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // Counts since start(), scaled up when the kernel had to multiplex
+  // counters. nullopt for counters that aren't available.
+  [[nodiscard]] auto read() const
+      -> std::array<std::optional<double>, count> {
+    std::array<std::optional<double>, count> values{};
+#if defined(__linux__)
+    for (std::size_t i = 0; i < count; ++i) {
+      // value, time enabled, time running
+      std::array<std::uint64_t, 3> data{};
+      if (fds[i] == -1 ||
+          ::read(fds[i], data.data(), sizeof(data)) !=
+              static_cast<ssize_t>(sizeof(data)) ||
+          data[2] == 0) {
+        continue;
+      }
+      values[i] = static_cast<double>(data[0]) *
+                  static_cast<double>(data[1]) /
+                  static_cast<double>(data[2]);
+    }
+#endif
+    return values;
+  }
+
+  static constexpr auto name(std::size_t i) -> char const* {
+    return events[i].name;
+  }
+
+ private:
+#if defined(__linux__)
+  static constexpr std::array<counter, count> events{{
+      {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {"branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+      {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {"l1d_misses", PERF_TYPE_HW_CACHE,
+       PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U)},
+  }};
+
+  static auto open(counter const& c) -> int {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = c.type;
+    attr.config = c.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(
+        ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+#else
+  static constexpr std::array<counter, count> events{{
+      {"cycles", 0, 0},
+      {"instructions", 0, 0},
+      {"branches", 0, 0},
+      {"branch_misses", 0, 0},
+      {"l1d_misses", 0, 0},
+  }};
+#endif
+
+  std::array<int, count> fds{-1, -1, -1, -1, -1};
+};
+
+// The counters of the main thread, which runs the benchmarks. Says once when
+// there are none.
+inline auto counters() -> perf_counters& {
+  static perf_counters c;
+  static bool const reported = [] {
+    if (!c.available()) {
+      std::fputs("performance counters unavailable, reporting timings only\n",
+                 stderr);
+    }
+    return true;
+  }();
+  static_cast<void>(reported);
+  return c;
+}
+
+}  // namespace bench
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// A ten stage chain over a 256 byte payload, evaluated eagerly with the
+// members of expected and lazily as an rd pipeline. The member chain
+// materializes an expected after every stage and tests each of them; the
+// pipeline hands the payload from stage to stage and builds one expected.
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/pipeline.hpp"
+
+namespace {
+struct error {
+  int code;
+};
+
+using payload = std::array<int, 64>;
+using result = rd::expected<payload, error>;
+
+constexpr std::size_t elements = 1024;
+
+auto make_results(double failure_rate) -> std::vector<result> {
+  std::mt19937 gen(42);  // NOLINT
+  std::bernoulli_distribution fails(failure_rate);
+  std::vector<result> r;
+  r.reserve(elements);
+  for (std::size_t i = 0; i < elements; ++i) {
+    if (fails(gen)) {
+      r.emplace_back(rd::unexpect, error{static_cast<int>(i)});
+    } else {
+      payload p{};
+      p[0] = static_cast<int>(i);
+      r.emplace_back(p);
+    }
+  }
+  return r;
+}
+
+auto bump(payload p) -> payload {
+  for (auto& x : p) {
+    ++x;
+  }
+  return p;
+}
+
+auto validate(payload p) -> result {
+  if (p[0] < 0) [[unlikely]] {
+    return rd::unexpected(error{p[0]});
+  }
+  return p;
+}
+
+auto tag(error e) -> error { return error{e.code + 1}; }
+
+auto consume(result const& r) -> int { return r ? (*r)[0] : r.error().code; }
+
+void compare(bench::state& state, char const* label, double failure_rate) {
+  auto const results = make_results(failure_rate);
+  auto const chain = rd::then(validate) | rd::map(bump) | rd::map(bump) |
+                     rd::then(validate) | rd::map(bump) | rd::map(bump) |
+                     rd::then(validate) | rd::map(bump) | rd::map(bump) |
+                     rd::map_error(tag);
+  state.run(std::string("member chain, ") + label, elements, [&] {
+    int sum = 0;
+    for (auto const& r : results) {
+      result out = r.and_then(validate)
+                       .transform(bump)
+                       .transform(bump)
+                       .and_then(validate)
+                       .transform(bump)
+                       .transform(bump)
+                       .and_then(validate)
+                       .transform(bump)
+                       .transform(bump)
+                       .transform_error(tag);
+      sum += consume(out);
+    }
+    bench::do_not_optimize(sum);
+  });
+  state.run(std::string("pipeline, ") + label, elements, [&] {
+    int sum = 0;
+    for (auto const& r : results) {
+      result out = chain(r);
+      sum += consume(out);
+    }
+    bench::do_not_optimize(sum);
+  });
+}
+}  // namespace
+
+BENCHMARK("pipeline: ten stages") {
+  compare(state, "all succeed", 0.0);
+  compare(state, "10% errors", 0.1);
+}
@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "rd/expected.hpp"
+
+namespace {
+enum class error { not_found, timeout };
+
+// Owns a heap buffer without pointing into itself, so it is safe to opt into
+// trivial relocation. Both instantiations are identical apart from the opt-in.
+template <bool Relocatable>
+struct payload {
+  explicit payload(std::size_t n)
+      : data(n == 0 ? nullptr : std::make_unique<char[]>(n)), size(n) {}
+
+  std::unique_ptr<char[]> data;  // NOLINT
+  std::size_t size;
+};
+
+template <bool Relocatable>
+using result = rd::expected<payload<Relocatable>, error>;
+
+// Grows like std::vector, but moves its elements with rd::relocate_at.
+template <class T>
+class growable {
+ public:
+  growable() = default;
+  growable(growable const&) = delete;
+  auto operator=(growable const&) -> growable& = delete;
+  ~growable() {
+    std::destroy(data, data + count);
+    std::allocator<T>{}.deallocate(data, capacity);
+  }
+
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    if (count == capacity) {
+      grow();
+    }
+    std::construct_at(data + count, std::forward<Args>(args)...);
+    ++count;
+  }
+
+ private:
+  void grow() {
+    std::size_t new_capacity = capacity == 0 ? 1 : 2 * capacity;
+    T* new_data = std::allocator<T>{}.allocate(new_capacity);
+    for (std::size_t i = 0; i < count; ++i) {
+      rd::relocate_at(data + i, new_data + i);
+    }
+    std::allocator<T>{}.deallocate(data, capacity);
+    data = new_data;
+    capacity = new_capacity;
+  }
+
+  T* data = nullptr;
+  std::size_t count = 0;
+  std::size_t capacity = 0;
+};
+
+constexpr std::size_t elements = 4096;
+
+template <bool Relocatable>
+auto make_results() -> std::vector<result<Relocatable>> {
+  std::mt19937 gen(42);  // NOLINT
+  std::uniform_int_distribution<std::size_t> size(1, 256);
+  std::vector<result<Relocatable>> results;
+  results.reserve(elements);
+  for (std::size_t i = 0; i < elements; ++i) {
+    if (i % 4 == 0) {
+      results.emplace_back(rd::unexpect, error::timeout);
+    } else {
+      results.emplace_back(std::in_place, size(gen));
+    }
+  }
+  return results;
+}
+
+template <bool Relocatable>
+auto key(result<Relocatable> const& r) -> std::size_t {
+  return r.has_value() ? r->size : 0;
+}
+
+template <bool Relocatable>
+void growth(bench::state& state, std::string_view label) {
+  state.run(label, elements, [] {
+    growable<result<Relocatable>> results;
+    for (std::size_t i = 0; i < elements; ++i) {
+      if (i % 4 == 0) {
+        results.emplace_back(rd::unexpect, error::not_found);
+      } else {
+        // empty payloads keep allocations out of the measurement
+        results.emplace_back(std::in_place, 0);
+      }
+    }
+    bench::do_not_optimize(results);
+  });
+}
+
+template <bool Relocatable>
+void random_swaps(bench::state& state, std::string_view label) {
+  auto results = make_results<Relocatable>();
+  std::mt19937 gen(7);  // NOLINT
+  std::uniform_int_distribution<std::size_t> index(0, elements - 1);
+  std::vector<std::pair<std::size_t, std::size_t>> pairs(elements);
+  for (auto& [i, j] : pairs) {
+    i = index(gen);
+    j = index(gen);
+  }
+  state.run(label, elements, [&] {
+    for (auto [i, j] : pairs) {
+      swap(results[i], results[j]);
+    }
+    bench::clobber_memory();
+  });
+}
+
+template <bool Relocatable>
+void sorting(bench::state& state, std::string_view label) {
+  auto results = make_results<Relocatable>();
+  bool ascending = true;
+  state.run(label, elements, [&] {
+    // alternating the order keeps every run a full sort
+    std::sort(results.begin(), results.end(),
+              [ascending](auto const& a, auto const& b) {
+                return ascending ? key<Relocatable>(a) < key<Relocatable>(b)
+                                 : key<Relocatable>(b) < key<Relocatable>(a);
+              });
+    ascending = !ascending;
+    bench::clobber_memory();
+  });
+}
+}  // namespace
+
+template <>
+struct rd::is_trivially_relocatable<payload<true>> : std::true_type {};
+
+BENCHMARK("relocation: container growth") {
+  growth<false>(state, "move + destroy");
+  growth<true>(state, "trivially relocatable");
+}
+
+BENCHMARK("relocation: swap of mixed states") {
+  random_swaps<false>(state, "move + destroy");
+  random_swaps<true>(state, "trivially relocatable");
+}
+
+BENCHMARK("relocation: sorting") {
+  sorting<false>(state, "move + destroy");
+  sorting<true>(state, "trivially relocatable");
+}
@@ -0,0 +1,71 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// One failure handed to many consumers from an lvalue, as and_then & does:
+// every consumer gets its own copy of the error. With a std::string error
+// each copy allocates and copies the message; with shared_error it bumps a
+// reference count, atomically or, with local_shared_error, not.
+
+#include <cstddef>
+#include <string>
+
+#include "bench.hpp"
+#include "rd/expected.hpp"
+#include "rd/shared_error.hpp"
+
+namespace {
+constexpr std::size_t consumers = 1024;
+
+template <class E>
+using result = rd::expected<int, E>;
+
+template <class E>
+[[gnu::noinline]] auto consume(int x) -> result<E> {
+  return x + 1;
+}
+
+template <class E>
+void fan_out(bench::state& state, char const* label,
+             std::size_t message_size) {
+  result<E> const failed = rd::unexpected(std::string(message_size, 'e'));
+  state.run(label, consumers, [&] {
+    std::size_t failures = 0;
+    for (std::size_t i = 0; i < consumers; ++i) {
+      auto r = failed.and_then(consume<E>);
+      failures += r.has_value() ? 0 : 1;
+      bench::do_not_optimize(r);
+    }
+    bench::do_not_optimize(failures);
+  }, {{"message bytes", static_cast<double>(message_size)}});
+}
+}  // namespace
+
+BENCHMARK("shared_error: fan out a failure from an lvalue") {
+  for (std::size_t size : {16, 256, 4096}) {
+    fan_out<std::string>(state, "std::string", size);
+    fan_out<rd::shared_error<std::string>>(state, "shared_error", size);
+    fan_out<rd::local_shared_error<std::string>>(state, "local_shared_error",
+                                                 size);
+  }
+}
@@ -0,0 +1,241 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "boxed.hpp"
+#include "error_message.hpp"
+
+#include "config.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+template <std::size_t Capacity>
+class basic_any_error;
+
+namespace detail {
+template <class T>
+inline constexpr bool is_any_error = false;
+
+template <std::size_t Capacity>
+inline constexpr bool is_any_error<basic_any_error<Capacity>> = true;
+
+// Its address identifies T without RTTI. Not const, so that identical code
+// folding can't merge the variables of different types.
+template <class T>
+inline char type_id = 0;  // NOLINT
+
+struct any_error_vtable {
+  void const* type;
+  auto (*object)(void const* storage) noexcept -> void const*;
+  auto (*message)(void const* storage) -> std::string;
+  void (*copy)(void const* from, void* to);
+  // Moves from's object to to and destroys it.
+  void (*relocate)(void* from, void* to) noexcept;
+  void (*destroy)(void* storage) noexcept;
+};
+
+inline std::atomic<std::size_t> any_error_heap_fallbacks{0};  // NOLINT
+
+// T is stored in the buffer as is, or as boxed<T> when it doesn't fit.
+template <class T, bool Boxed>
+struct any_error_ops {
+  using stored = std::conditional_t<Boxed, boxed<T>, T>;
+
+  static auto object(void const* storage) noexcept -> void const* {
+    if constexpr (Boxed) {
+      return &**static_cast<stored const*>(storage);
+    } else {
+      return storage;
+    }
+  }
+
+  static auto message(void const* storage) -> std::string {
+    return rd::error_message(*static_cast<T const*>(object(storage)));
+  }
+
+  static void copy(void const* from, void* to) {
+    ::new (to) stored(*static_cast<stored const*>(from));
+    if constexpr (Boxed) {
+      any_error_heap_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  static void relocate(void* from, void* to) noexcept {
+    ::new (to) stored(std::move(*static_cast<stored*>(from)));
+    std::destroy_at(static_cast<stored*>(from));
+  }
+
+  static void destroy(void* storage) noexcept {
+    std::destroy_at(static_cast<stored*>(storage));
+  }
+
+  static constexpr any_error_vtable vtable = {
+      &type_id<T>, &object, &message, &copy, &relocate, &destroy};
+};
+}  // namespace detail
+
+// Number of errors that any_error had to allocate on the heap because they
+// didn't fit in its buffer, for all capacities, since the program started.
+inline auto any_error_heap_fallbacks() noexcept -> std::size_t {
+  return detail::any_error_heap_fallbacks.load(std::memory_order_relaxed);
+}
+
+// Holds an error of any copyable type. Errors of up to Capacity bytes that
+// can be moved without throwing are stored inline, larger ones in a
+// rd::boxed. Used as the error type of expected, errors of different
+// subsystems can cross layers without allocating.
+//
+// Copying copies the error; moving leaves the source valueless.
+template <std::size_t Capacity>
+class basic_any_error {
+  static_assert(Capacity >= sizeof(void*), "any_error must fit a pointer");
+
+ public:
+  static constexpr std::size_t capacity = Capacity;
+
+  // Whether errors of type T are stored inline.
+  template <class T>
+  static constexpr bool fits_inline =
+      sizeof(T) <= Capacity && alignof(T) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<T>;
+
+  template <class T, class... Args>
+  requires std::constructible_from<T, Args...> && std::copy_constructible<T>
+  explicit basic_any_error(std::in_place_type_t<T> /*unused*/, Args&&... args)
+      : vtable(&detail::any_error_ops<T, !fits_inline<T>>::vtable) {
+    if constexpr (fits_inline<T>) {
+      ::new (static_cast<void*>(buffer)) T(std::forward<Args>(args)...);
+    } else {
+      ::new (static_cast<void*>(buffer))
+          boxed<T>(std::in_place, std::forward<Args>(args)...);
+      detail::any_error_heap_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // expected and unexpected are excluded, which also keeps copying an
+  // expected<T, any_error> from asking whether any_error is constructible
+  // from it.
+  template <class G>
+  requires(!detail::is_any_error<std::remove_cvref_t<G>>) &&
+      (!detail::is_expected<std::remove_cvref_t<G>>) &&
+      (!detail::is_unexpected<std::remove_cvref_t<G>>) &&
+      std::copy_constructible<std::decay_t<G>> &&
+      std::constructible_from<std::decay_t<G>, G>
+  basic_any_error(G&& e)  // NOLINT
+      : basic_any_error(std::in_place_type<std::decay_t<G>>,
+                        std::forward<G>(e)) {}
+
+  basic_any_error(basic_any_error const& rhs) : vtable(rhs.vtable) {
+    if (vtable != nullptr) {
+      vtable->copy(rhs.buffer, buffer);
+    }
+  }
+
+  // postcondition: rhs.valueless_after_move() = true
+  basic_any_error(basic_any_error&& rhs) noexcept
+      : vtable(std::exchange(rhs.vtable, nullptr)) {
+    if (vtable != nullptr) {
+      vtable->relocate(rhs.buffer, buffer);
+    }
+  }
+
+  auto operator=(basic_any_error const& rhs) -> basic_any_error& {
+    if (this != &rhs) {
+      *this = basic_any_error(rhs);
+    }
+    return *this;
+  }
+
+  // postcondition: rhs.valueless_after_move() = true, unless rhs is *this
+  auto operator=(basic_any_error&& rhs) noexcept -> basic_any_error& {
+    if (this != &rhs) {
+      reset();
+      vtable = std::exchange(rhs.vtable, nullptr);
+      if (vtable != nullptr) {
+        vtable->relocate(rhs.buffer, buffer);
+      }
+    }
+    return *this;
+  }
+
+  ~basic_any_error() { reset(); }
+
+  // The error if it is a T, nullptr otherwise.
+  template <class T>
+  [[nodiscard]] auto error_as() noexcept -> T* {
+    return const_cast<T*>(std::as_const(*this).template error_as<T>());
+  }
+
+  template <class T>
+  [[nodiscard]] auto error_as() const noexcept -> T const* {
+    if (vtable == nullptr || vtable->type != &detail::type_id<T>) {
+      return nullptr;
+    }
+    return static_cast<T const*>(vtable->object(buffer));
+  }
+
+  // The rd::error_message of the error.
+  //
+  // precondition: valueless_after_move() = false
+  [[nodiscard]] auto message() const -> std::string {
+    return vtable->message(buffer);
+  }
+
+  [[nodiscard]] auto valueless_after_move() const noexcept -> bool {
+    return vtable == nullptr;
+  }
+
+  friend void swap(basic_any_error& x, basic_any_error& y) noexcept {
+    basic_any_error tmp(std::move(x));
+    x = std::move(y);
+    y = std::move(tmp);
+  }
+
+ private:
+  void reset() noexcept {
+    if (vtable != nullptr) {
+      vtable->destroy(buffer);
+      vtable = nullptr;
+    }
+  }
+
+  detail::any_error_vtable const* vtable;
+  alignas(std::max_align_t) unsigned char buffer[Capacity];
+};
+
+using any_error = basic_any_error<32>;
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
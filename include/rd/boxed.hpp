@@ -0,0 +1,223 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "error_arena.hpp"
+#include "expected.hpp"
+
+#include "config.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+template <class E>
+class boxed;
+
+namespace detail {
+template <class T>
+inline constexpr bool is_boxed = false;
+
+template <class E>
+inline constexpr bool is_boxed<boxed<E>> = true;
+
+// A boxed E is allocated from the current error arena, preceded by the
+// resource it came from. Allocator-aware Es get an allocator for that
+// resource too.
+template <class E>
+struct boxed_block {
+  using resource_ptr = std::pmr::memory_resource*;
+
+  static constexpr std::size_t offset =
+      (sizeof(resource_ptr) + alignof(E) - 1) / alignof(E) * alignof(E);
+  static constexpr std::size_t size = offset + sizeof(E);
+  static constexpr std::size_t align = alignof(E) > alignof(resource_ptr)
+                                           ? alignof(E)
+                                           : alignof(resource_ptr);
+
+  template <class... Args>
+  static auto create(Args&&... args) -> E* {
+    resource_ptr resource = error_arena::current();
+    auto* block = static_cast<unsigned char*>(resource->allocate(size, align));
+    ::new (static_cast<void*>(block)) resource_ptr(resource);
+    if constexpr (exceptions_enabled) {
+      RD_EXPECTED_TRY {
+        return construct(block, resource, std::forward<Args>(args)...);
+      } RD_EXPECTED_CATCH_ALL {
+        resource->deallocate(block, size, align);
+        RD_EXPECTED_RETHROW;
+      }
+    } else {
+      return construct(block, resource, std::forward<Args>(args)...);
+    }
+  }
+
+  template <class... Args>
+  static auto construct(unsigned char* block, resource_ptr resource,
+                        Args&&... args) -> E* {
+    return std::uninitialized_construct_using_allocator(
+        reinterpret_cast<E*>(block + offset),  // NOLINT
+        std::pmr::polymorphic_allocator<>(resource),
+        std::forward<Args>(args)...);
+  }
+
+  static void destroy(E* e) noexcept {
+    auto* block = reinterpret_cast<unsigned char*>(e) - offset;  // NOLINT
+    resource_ptr resource =
+        *std::launder(reinterpret_cast<resource_ptr*>(block));  // NOLINT
+    std::destroy_at(e);
+    resource->deallocate(block, size, align);
+  }
+};
+}  // namespace detail
+
+// Keeps an E on the heap behind a pointer. Used as the error type of
+// expected, it keeps large errors out of the expected object: the size of
+// expected<T, boxed<E>> doesn't depend on E, and moving the error moves a
+// pointer. Copying copies the E.
+//
+// The E is allocated from rd::error_arena::current(), i.e. from the default
+// memory resource outside of any error arena.
+template <class E>
+class boxed {
+ public:
+  using value_type = E;
+
+  template <class... Args>
+  requires std::constructible_from<E, Args...>
+  explicit boxed(std::in_place_t /*unused*/, Args&&... args)
+      : ptr(block::create(std::forward<Args>(args)...)) {}
+
+  template <class G = E>
+  requires(!std::same_as<std::remove_cvref_t<G>, boxed>) &&
+      (!std::same_as<std::remove_cvref_t<G>, std::in_place_t>) &&
+      std::constructible_from<E, G>
+  explicit(!std::convertible_to<G, E>) boxed(G&& e)  // NOLINT
+      : ptr(block::create(std::forward<G>(e))) {}
+
+  boxed(boxed const& rhs) requires std::copy_constructible<E>
+      : ptr(rhs.ptr == nullptr ? nullptr : block::create(*rhs.ptr)) {}
+
+  // postcondition: rhs.valueless_after_move() = true
+  constexpr boxed(boxed&& rhs) noexcept
+      : ptr(std::exchange(rhs.ptr, nullptr)) {}
+
+  auto operator=(boxed const& rhs) -> boxed&
+      requires std::copy_constructible<E> && std::is_copy_assignable_v<E> {
+    if (ptr != nullptr && rhs.ptr != nullptr) {
+      *ptr = *rhs.ptr;
+    } else if (this != &rhs) {
+      boxed(rhs).swap(*this);
+    }
+    return *this;
+  }
+
+  // postcondition: rhs.valueless_after_move() = true, unless rhs is *this
+  auto operator=(boxed&& rhs) noexcept -> boxed& {
+    if (this != &rhs) {
+      boxed(std::move(rhs)).swap(*this);
+    }
+    return *this;
+  }
+
+  ~boxed() {
+    if (ptr != nullptr) {
+      block::destroy(ptr);
+    }
+  }
+
+  // observers
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator*() const& noexcept -> E const& { return *ptr; }
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator*() & noexcept -> E& { return *ptr; }
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator*() const&& noexcept -> E const&& {
+    return std::move(*ptr);
+  }
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator*() && noexcept -> E&& { return std::move(*ptr); }
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator->() const noexcept -> E const* { return ptr; }
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator->() noexcept -> E* { return ptr; }
+
+  [[nodiscard]] constexpr auto valueless_after_move() const noexcept -> bool {
+    return ptr == nullptr;
+  }
+
+  constexpr void swap(boxed& other) noexcept { std::swap(ptr, other.ptr); }
+
+  friend constexpr void swap(boxed& x, boxed& y) noexcept { x.swap(y); }
+
+  // equality operators compare the boxed errors
+  template <class E2>
+  requires requires(E const& x, E2 const& y) {
+    { x == y } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(boxed const& x, boxed<E2> const& y)
+      -> bool {
+    return *x == *y;
+  }
+
+  // Self is deduced for the same reason as in expected's == with a value.
+  template <class Self, class G>
+  requires std::same_as<Self, boxed> &&
+      (!detail::is_boxed<G>) &&
+      requires(E const& x, G const& y) {
+    { x == y } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(Self const& x, G const& y) -> bool {
+    return *x == y;
+  }
+
+ private:
+  using block = detail::boxed_block<E>;
+
+  E* ptr;
+};
+
+template <class E>
+boxed(E) -> boxed<E>;
+
+template <class E>
+struct is_trivially_relocatable<boxed<E>> : std::true_type {};
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
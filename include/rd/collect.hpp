@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "expected.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+namespace detail {
+template <class R>
+concept range_of_expected =
+    std::ranges::input_range<R> &&
+    is_expected<std::ranges::range_value_t<R>> &&
+    !std::is_void_v<typename std::ranges::range_value_t<R>::value_type>;
+
+template <class R>
+using range_error_t = typename std::ranges::range_value_t<R>::error_type;
+
+// Elements are moved out of ranges owning them that are passed as rvalues,
+// and out of ranges producing temporaries. Views are never moved from, since
+// they refer to elements owned elsewhere.
+template <class R>
+inline constexpr bool moves_elements =
+    !std::is_reference_v<std::ranges::range_reference_t<R>> ||
+    (!std::is_lvalue_reference_v<R> &&
+     !std::ranges::view<std::remove_cvref_t<R>>);
+
+template <class R, class X>
+constexpr auto element(X& x) -> decltype(auto) {
+  if constexpr (moves_elements<R>) {
+    return std::move(x);
+  } else {
+    return std::as_const(x);
+  }
+}
+
+template <class Container, class R>
+constexpr void reserve_for(Container& c, R& r) {
+  if constexpr (std::ranges::sized_range<R> &&
+                requires(std::size_t n) { c.reserve(n); }) {
+    c.reserve(static_cast<std::size_t>(std::ranges::size(r)));
+  }
+}
+
+// push_back for sequences, insert for sets and maps.
+template <class Container, class V>
+constexpr void append(Container& c, V&& v) {
+  if constexpr (requires { c.emplace_back(std::forward<V>(v)); }) {
+    c.emplace_back(std::forward<V>(v));
+  } else if constexpr (requires { c.emplace(std::forward<V>(v)); }) {
+    c.emplace(std::forward<V>(v));
+  } else {
+    c.insert(c.end(), std::forward<V>(v));
+  }
+}
+}  // namespace detail
+
+// Turns a range of expected<T, E> into an expected<Container, E> holding the
+// values, or the first error. Stops at the first error. Capacity is reserved
+// up front for sized ranges, and elements are moved out of rvalue containers
+// and out of ranges producing temporaries.
+//
+//   auto ids = rd::collect<std::vector<int>>(parse_all(lines));
+template <class Container, class R>
+requires detail::range_of_expected<R>
+constexpr auto collect(R&& r) -> expected<Container, detail::range_error_t<R>> {
+  using result = expected<Container, detail::range_error_t<R>>;
+  result out;
+  detail::reserve_for(*out, r);
+  for (auto&& x : r) {
+    if (!x.has_value()) [[unlikely]] {
+      return result(unexpect, detail::element<R>(x).error());
+    }
+    detail::append(*out, *detail::element<R>(x));
+  }
+  return out;
+}
+
+// Like collect, but goes through the whole range and gathers every error in
+// Errors, a std::vector of the errors by default.
+template <class Container, class Errors = void, class R>
+requires detail::range_of_expected<R>
+constexpr auto collect_all_errors(R&& r)
+    -> expected<Container,
+                std::conditional_t<std::is_void_v<Errors>,
+                                   std::vector<detail::range_error_t<R>>,
+                                   Errors>> {
+  using errors_type =
+      std::conditional_t<std::is_void_v<Errors>,
+                         std::vector<detail::range_error_t<R>>, Errors>;
+  using result = expected<Container, errors_type>;
+  result out;
+  detail::reserve_for(*out, r);
+  errors_type errors;
+  for (auto&& x : r) {
+    if (!x.has_value()) [[unlikely]] {
+      detail::append(errors, detail::element<R>(x).error());
+    } else if (errors.empty()) {
+      detail::append(*out, *detail::element<R>(x));
+    }
+  }
+  if (!errors.empty()) {
+    return result(unexpect, std::move(errors));
+  }
+  return out;
+}
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
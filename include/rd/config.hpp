@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Macros shared by the headers of the library.
+
+// Hardening checks the preconditions of operator*, operator-> and error().
+// Define RD_EXPECTED_HARDENING to one of these; violations trap in the fast
+// mode and are reported to the precondition handler in the verbose mode.
+#define RD_EXPECTED_HARDENING_OFF 0
+#define RD_EXPECTED_HARDENING_TRAP 1
+#define RD_EXPECTED_HARDENING_VERBOSE 2
+
+#ifndef RD_EXPECTED_HARDENING
+#define RD_EXPECTED_HARDENING RD_EXPECTED_HARDENING_OFF
+#endif
+
+// The headers declare the library in an inline namespace of rd named after
+// the hardening mode. Translation units built in different modes then define
+// different entities rather than conflicting definitions of the same ones,
+// and passing an expected from one to the other fails to link.
+#define RD_EXPECTED_ABI_NAMESPACE_(mode) hardening_##mode
+#define RD_EXPECTED_ABI_NAMESPACE_EXPAND_(mode) RD_EXPECTED_ABI_NAMESPACE_(mode)
+#define RD_EXPECTED_ABI_NAMESPACE \
+  RD_EXPECTED_ABI_NAMESPACE_EXPAND_(RD_EXPECTED_HARDENING)
+
+// Exception handling that compiles away without exceptions. Clang rejects
+// try and throw under -fno-exceptions even in discarded if constexpr
+// branches, so the headers spell them with these.
+#ifdef __cpp_exceptions
+#define RD_EXPECTED_TRY try
+#define RD_EXPECTED_CATCH_ALL catch (...)
+#define RD_EXPECTED_RETHROW throw
+#else
+#define RD_EXPECTED_TRY if (true)
+#define RD_EXPECTED_CATCH_ALL if (false)
+#define RD_EXPECTED_RETHROW static_cast<void>(0)
+#endif
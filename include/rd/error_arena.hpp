@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+#include "config.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+// Bump allocator for error payloads, meant to live as long as a request.
+// Allocations never free memory on their own; everything is released at once
+// when the arena is destroyed.
+//
+// Constructing an arena makes it the current arena of the calling thread
+// until it's destroyed, so arenas must be destroyed in the reverse order of
+// their construction. rd::boxed and errors that take rd::error_allocator()
+// allocate from the current arena. Such errors must not outlive the arena.
+class error_arena : public std::pmr::monotonic_buffer_resource {
+ public:
+  error_arena() : error_arena(std::pmr::get_default_resource()) {}
+
+  // Chunks are allocated from upstream.
+  explicit error_arena(std::pmr::memory_resource* upstream)
+      : monotonic_buffer_resource(upstream), previous(std::exchange(top, this)) {}
+
+  // Allocates from buffer first, then from upstream once it's used up.
+  error_arena(void* buffer, std::size_t size,
+              std::pmr::memory_resource* upstream =
+                  std::pmr::get_default_resource())
+      : monotonic_buffer_resource(buffer, size, upstream),
+        previous(std::exchange(top, this)) {}
+
+  error_arena(error_arena const&) = delete;
+  error_arena(error_arena&&) = delete;
+  auto operator=(error_arena const&) -> error_arena& = delete;
+  auto operator=(error_arena&&) -> error_arena& = delete;
+
+  // precondition: *this is the current arena
+  ~error_arena() override { top = previous; }
+
+  // The innermost arena of the calling thread, or the default memory resource
+  // outside of any arena.
+  static auto current() noexcept -> std::pmr::memory_resource* {
+    if (top != nullptr) {
+      return top;
+    }
+    return std::pmr::get_default_resource();
+  }
+
+ private:
+  static inline thread_local error_arena* top = nullptr;
+
+  error_arena* previous;
+};
+
+// Allocator for allocator-aware error types that should draw from the current
+// arena:
+//
+//   struct my_error {
+//     using allocator_type = std::pmr::polymorphic_allocator<>;
+//
+//     explicit my_error(std::string_view msg,
+//                       allocator_type alloc = rd::error_allocator())
+//         : message(msg, alloc) {}
+//
+//     std::pmr::string message;
+//   };
+inline auto error_allocator() noexcept -> std::pmr::polymorphic_allocator<> {
+  return std::pmr::polymorphic_allocator<>(error_arena::current());
+}
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
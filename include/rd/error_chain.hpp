@@ -0,0 +1,270 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "error_arena.hpp"
+#include "error_message.hpp"
+#include "expected.hpp"
+
+#include "config.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+// An E with the context it was propagated through, most recent first:
+//
+//   return parse(text).context("while parsing the header");
+//
+// Frames live in a fixed inline ring of Frames slots; once it is full the
+// oldest frames are dropped and counted. A static_context frame is a pointer
+// to its text, so adding one never allocates. Other text is copied into the
+// error arena that was current when the chain was made. Only message()
+// builds a string.
+template <class E, std::size_t Frames = 8>
+class error_chain {
+  static_assert(Frames > 0 && Frames <= 64);
+
+ public:
+  using error_type = E;
+
+  static constexpr std::size_t capacity = Frames;
+
+  // constructors
+  template <class... Args>
+  requires std::constructible_from<E, Args...>
+  explicit error_chain(std::in_place_t /*unused*/, Args&&... args)
+      : err(std::forward<Args>(args)...) {}
+
+  template <class G = E>
+  requires(!std::same_as<std::remove_cvref_t<G>, error_chain>) &&
+      (!std::same_as<std::remove_cvref_t<G>, std::in_place_t>) &&
+      std::constructible_from<E, G>
+  explicit(!std::convertible_to<G, E>) error_chain(G&& e)  // NOLINT
+      : err(std::forward<G>(e)) {}
+
+  error_chain(error_chain const& rhs) requires std::copy_constructible<E>
+      : err(rhs.err), frames(rhs.frames), pushes(rhs.pushes) {
+    if constexpr (detail::exceptions_enabled) {
+      RD_EXPECTED_TRY {
+        copy_owned(rhs);
+      } RD_EXPECTED_CATCH_ALL {
+        release();
+        RD_EXPECTED_RETHROW;
+      }
+    } else {
+      copy_owned(rhs);
+    }
+  }
+
+  // postcondition: rhs.size() = 0
+  error_chain(error_chain&& rhs) noexcept(
+      std::is_nothrow_move_constructible_v<E>)
+      requires std::move_constructible<E>
+      : err(std::move(rhs.err)),
+        frames(rhs.frames),
+        pushes(std::exchange(rhs.pushes, 0)),
+        owned(std::exchange(rhs.owned, 0)),
+        resource(rhs.resource) {}
+
+  auto operator=(error_chain const& rhs) -> error_chain&
+      requires std::copy_constructible<E> && std::is_nothrow_swappable_v<E> {
+    if (this != &rhs) {
+      error_chain(rhs).swap(*this);
+    }
+    return *this;
+  }
+
+  // postcondition: rhs.size() = 0, unless rhs is *this
+  auto operator=(error_chain&& rhs) noexcept(
+      std::is_nothrow_move_constructible_v<E>) -> error_chain&
+      requires std::move_constructible<E> && std::is_nothrow_swappable_v<E> {
+    if (this != &rhs) {
+      error_chain(std::move(rhs)).swap(*this);
+    }
+    return *this;
+  }
+
+  ~error_chain() { release(); }
+
+  // modifiers
+
+  // Keeps a pointer to c's text.
+  void add_context(static_context c) noexcept { push(c.text); }
+
+  // Keeps a copy of text.
+  template <class S>
+  requires std::convertible_to<S const&, std::string_view>
+  void add_context(S const& text) {
+    push(copy(std::string_view(text)));
+    owned |= bit((pushes - 1) % Frames);
+  }
+
+  // observers
+  constexpr auto error() & noexcept -> E& { return err; }
+  constexpr auto error() const& noexcept -> E const& { return err; }
+  constexpr auto error() && noexcept -> E&& { return std::move(err); }
+  constexpr auto error() const&& noexcept -> E const&& {
+    return std::move(err);
+  }
+
+  // Number of frames kept.
+  [[nodiscard]] constexpr auto size() const noexcept -> std::size_t {
+    return std::min(pushes, Frames);
+  }
+
+  // Number of frames dropped because the ring was full.
+  [[nodiscard]] constexpr auto dropped() const noexcept -> std::size_t {
+    return pushes - size();
+  }
+
+  // context(0) is the most recently added frame.
+  //
+  // precondition: i < size()
+  [[nodiscard]] auto context(std::size_t i) const noexcept
+      -> std::string_view {
+    return frame((pushes - 1 - i) % Frames);
+  }
+
+  // "outer: inner: <error message>", with "..." for dropped frames.
+  [[nodiscard]] auto message() const -> std::string {
+    std::string result;
+    for (std::size_t i = 0; i < size(); ++i) {
+      result.append(context(i)).append(": ");
+    }
+    if (dropped() != 0) {
+      result.append("...: ");
+    }
+    return result.append(rd::error_message(err));
+  }
+
+  void swap(error_chain& other) noexcept(
+      std::is_nothrow_swappable_v<E>) {
+    using std::swap;
+    swap(err, other.err);
+    swap(frames, other.frames);
+    swap(pushes, other.pushes);
+    swap(owned, other.owned);
+    swap(resource, other.resource);
+  }
+
+  friend void swap(error_chain& x, error_chain& y) noexcept(
+      noexcept(x.swap(y))) {
+    x.swap(y);
+  }
+
+ private:
+  static constexpr auto bit(std::size_t i) noexcept -> std::uint64_t {
+    return std::uint64_t{1} << i;
+  }
+
+  [[nodiscard]] constexpr auto owns(std::size_t i) const noexcept -> bool {
+    return (owned & bit(i)) != 0;
+  }
+
+  // A copied frame is preceded by its length, so that text with embedded
+  // NULs is kept whole and exactly the allocated size is given back.
+  static constexpr std::size_t prefix = sizeof(std::size_t);
+
+  static auto length(char const* owned_frame) noexcept -> std::size_t {
+    std::size_t n = 0;
+    std::memcpy(&n, owned_frame - prefix, prefix);
+    return n;
+  }
+
+  [[nodiscard]] auto frame(std::size_t i) const noexcept -> std::string_view {
+    if (owns(i)) {
+      return {frames[i], length(frames[i])};
+    }
+    return frames[i];
+  }
+
+  void push(char const* text) noexcept {
+    if (owned != 0) {
+      release(pushes % Frames);
+    }
+    frames[pushes % Frames] = text;
+    ++pushes;
+  }
+
+  void copy_owned(error_chain const& rhs) {
+    for (std::size_t i = 0; i < Frames; ++i) {
+      if (rhs.owns(i)) {
+        frames[i] = copy(rhs.frame(i));
+        owned |= bit(i);
+      }
+    }
+  }
+
+  auto copy(std::string_view text) const -> char* {
+    std::size_t const n = text.size();
+    auto* block = static_cast<char*>(
+        resource->allocate(prefix + n, alignof(std::size_t)));
+    std::memcpy(block, &n, prefix);
+    std::memcpy(block + prefix, text.data(), n);
+    return block + prefix;
+  }
+
+  void release(std::size_t i) noexcept {
+    if (owns(i)) {
+      char const* text = frames[i];
+      resource->deallocate(const_cast<char*>(text - prefix),  // NOLINT
+                           prefix + length(text), alignof(std::size_t));
+      owned &= ~bit(i);
+    }
+  }
+
+  void release() noexcept {
+    for (std::size_t i = 0; owned != 0; ++i) {
+      release(i);
+    }
+  }
+
+  E err;
+  std::array<char const*, Frames> frames{};
+  std::size_t pushes = 0;
+  std::uint64_t owned = 0;
+  std::pmr::memory_resource* resource = error_arena::current();
+};
+
+// Frames are pointers to static or separately allocated text.
+template <class E, std::size_t Frames>
+struct is_trivially_relocatable<error_chain<E, Frames>>
+    : is_trivially_relocatable<E> {};
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
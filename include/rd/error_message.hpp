@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <concepts>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "config.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+namespace detail {
+template <class T>
+concept has_message = requires(T const& e) {
+  { e.message() } -> std::convertible_to<std::string>;
+};
+
+template <class T>
+concept has_what = requires(T const& e) {
+  { e.what() } -> std::convertible_to<std::string_view>;
+};
+}  // namespace detail
+
+// Describes an error of any type: its message() or what() if it has one, the
+// message of its error_code for error code enums, the error itself for
+// strings.
+template <class E>
+auto error_message(E const& e) -> std::string {
+  if constexpr (detail::has_message<E>) {
+    return e.message();
+  } else if constexpr (detail::has_what<E>) {
+    return std::string(e.what());
+  } else if constexpr (std::is_error_code_enum_v<E>) {
+    return make_error_code(e).message();
+  } else if constexpr (std::is_error_condition_enum_v<E>) {
+    return make_error_condition(e).message();
+  } else if constexpr (std::is_constructible_v<std::string, E const&>) {
+    return std::string(e);
+  } else {
+    return "unknown error";
+  }
+}
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The rd.expected module: everything the headers in include/rd declare.
+// Macros don't cross the module boundary, so RD_EXPECTED_HARDENING and
+// RD_EXPECTED_NO_EXCEPTIONS take effect when they're defined while building
+// the module.
+//
+// The headers are included in the purview, inside extern "C++": their
+// declarations stay attached to the global module, so a program can import
+// the module in some files and include the headers in others. Every standard
+// header they include must be in the global module fragment first, so that
+// the standard library isn't declared in the purview; test/module/
+// check_module.cmake checks this list against the headers.
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <forward_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module rd.expected;
+
+export extern "C++" {
+#include "any_error.hpp"
+#include "boxed.hpp"
+#include "collect.hpp"
+#include "error_arena.hpp"
+#include "error_chain.hpp"
+#include "error_message.hpp"
+#include "expected.hpp"
+#include "pipeline.hpp"
+#include "shared_error.hpp"
+#include "status_code.hpp"
+}
@@ -24,16 +24,38 @@
 
 #pragma once
 
+#include <atomic>
+#include <bit>
+#include <climits>
 #include <concepts>
-#include <deque>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
-#include <functional>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
-#include <variant>
+
+#include "config.hpp"
+
+// Without exceptions value() reports a missing value to the bad access
+// handler. Define RD_EXPECTED_NO_EXCEPTIONS to get that with exceptions
+// enabled too.
+#if !defined(__cpp_exceptions) && !defined(RD_EXPECTED_NO_EXCEPTIONS)
+#define RD_EXPECTED_NO_EXCEPTIONS
+#endif
+
+#if RD_EXPECTED_HARDENING == RD_EXPECTED_HARDENING_OFF
+#define RD_EXPECTED_PRECONDITION(cond, violation) static_cast<void>(0)
+#else
+#define RD_EXPECTED_PRECONDITION(cond, violation) \
+  ::rd::detail::check_precondition<RD_EXPECTED_HARDENING>(cond, violation)
+#endif
 
 namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
 
 template <class E>
 class unexpected {
@@ -134,9 +156,241 @@ class bad_expected_access : public bad_expected_access<void> {
   E val;
 };
 
+// Called by value() instead of throwing when exceptions are unavailable, i.e.
+// with RD_EXPECTED_NO_EXCEPTIONS defined. The program is aborted if the
+// handler returns.
+using bad_access_handler = void (*)(bad_expected_access<void> const&);
+
+[[noreturn]] inline void terminate_on_bad_access(
+    bad_expected_access<void> const& /*unused*/) noexcept {
+  std::terminate();
+}
+
+[[noreturn]] inline void log_and_abort_on_bad_access(
+    bad_expected_access<void> const& e) noexcept {
+  std::fputs("rd::expected: ", stderr);
+  std::fputs(e.what(), stderr);
+  std::fputc('\n', stderr);
+  std::abort();
+}
+
+namespace detail {
+inline std::atomic<bad_access_handler> current_bad_access_handler{
+    &log_and_abort_on_bad_access};
+
+#ifdef __cpp_exceptions
+inline constexpr bool exceptions_enabled = true;
+#else
+inline constexpr bool exceptions_enabled = false;
+#endif
+
+// The INVOKE rules for a pointer to a member of C: applied to an object of C,
+// to anything that dereferences to one, or to a std::reference_wrapper.
+template <class M, class C, class Obj, class... Args>
+constexpr auto invoke_member(M C::*f, Obj&& obj, Args&&... args)
+    -> decltype(auto) {
+  if constexpr (std::is_base_of_v<C, std::remove_cvref_t<Obj>>) {
+    if constexpr (std::is_function_v<M>) {
+      return (std::forward<Obj>(obj).*f)(std::forward<Args>(args)...);
+    } else {
+      return std::forward<Obj>(obj).*f;
+    }
+  } else if constexpr (requires { *std::forward<Obj>(obj); }) {
+    return detail::invoke_member(f, *std::forward<Obj>(obj),
+                                 std::forward<Args>(args)...);
+  } else {
+    return detail::invoke_member(f, obj.get(), std::forward<Args>(args)...);
+  }
+}
+
+// std::invoke without <functional>, calling plain callables directly instead
+// of through the helpers std::invoke instantiates for every call.
+template <class F, class... Args>
+constexpr auto invoke(F&& f, Args&&... args) -> decltype(auto) {
+  if constexpr (std::is_member_pointer_v<std::remove_cvref_t<F>>) {
+    return detail::invoke_member(f, std::forward<Args>(args)...);
+  } else {
+    return std::forward<F>(f)(std::forward<Args>(args)...);
+  }
+}
+}  // namespace detail
+
+// Installs h and returns the previous handler.
+inline auto set_bad_access_handler(bad_access_handler h) noexcept
+    -> bad_access_handler {
+  return detail::current_bad_access_handler.exchange(
+      h == nullptr ? &log_and_abort_on_bad_access : h);
+}
+
+inline auto get_bad_access_handler() noexcept -> bad_access_handler {
+  return detail::current_bad_access_handler.load();
+}
+
+// Called on a precondition violation in the verbose hardening mode. The
+// program is aborted if the handler returns.
+using precondition_handler = void (*)(char const* violation);
+
+[[noreturn]] inline void log_and_abort_on_precondition_violation(
+    char const* violation) noexcept {
+  std::fputs("rd::expected: precondition violated: ", stderr);
+  std::fputs(violation, stderr);
+  std::fputc('\n', stderr);
+  std::abort();
+}
+
+namespace detail {
+inline std::atomic<precondition_handler> current_precondition_handler{
+    &log_and_abort_on_precondition_violation};
+}  // namespace detail
+
+// Installs h and returns the previous handler.
+inline auto set_precondition_handler(precondition_handler h) noexcept
+    -> precondition_handler {
+  return detail::current_precondition_handler.exchange(
+      h == nullptr ? &log_and_abort_on_precondition_violation : h);
+}
+
+inline auto get_precondition_handler() noexcept -> precondition_handler {
+  return detail::current_precondition_handler.load();
+}
+
+namespace detail {
+[[noreturn, gnu::cold, gnu::noinline]] inline void precondition_violated(
+    char const* violation) noexcept {
+  get_precondition_handler()(violation);
+  std::abort();
+}
+
+// The mode is a template argument, so that translation units hardened
+// differently don't share a definition.
+template <int Mode>
+constexpr void check_precondition(bool holds, char const* violation) noexcept {
+  if (holds) [[likely]] {
+    return;
+  }
+  if constexpr (Mode == RD_EXPECTED_HARDENING_TRAP) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_trap();
+#else
+    std::abort();
+#endif
+  } else {
+    precondition_violated(violation);
+  }
+}
+
+// Failure paths are kept out of line: callers of value() only see a call on
+// the unlikely branch, and all of them share one copy of the throw.
+template <class E>
+[[noreturn, gnu::cold, gnu::noinline]] void throw_bad_expected_access(E&& e) {
+#ifdef RD_EXPECTED_NO_EXCEPTIONS
+  get_bad_access_handler()(
+      bad_expected_access<std::remove_cvref_t<E>>(std::forward<E>(e)));
+  std::abort();
+#else
+  throw bad_expected_access<std::remove_cvref_t<E>>(std::forward<E>(e));
+#endif
+}
+}  // namespace detail
+
 struct unexpect_t {};
 inline constexpr unexpect_t unexpect{};
 
+// Text of a context frame known at compile time. The constructor is consteval,
+// so the text has static storage duration and a frame can be kept by pointer.
+struct static_context {
+  consteval static_context(char const* t) noexcept  // NOLINT
+      : text(t) {}
+
+  char const* text;
+};
+
+// Customization point describing a niche of T: a bit pattern that no valid
+// T ever holds. A specialization names one byte of T's object representation
+// (offset) and a pattern (tag) under mask within that byte. expected<T, E>
+// keeps its state in that byte instead of a separate flag whenever E fits in
+// the remaining bytes of T.
+template <class T>
+struct niche_traits {};
+
+// Base for niche_traits specializations of pointers: object pointers to types
+// aligned to at least 2 never have the lowest bit set. T must be complete
+// where expected<T*, E> is instantiated.
+template <class T>
+struct pointer_niche {
+  static_assert(alignof(T) >= 2, "the lowest bit of a T* must be free");
+  static constexpr std::size_t offset =
+      std::endian::native == std::endian::little ? 0 : sizeof(T*) - 1;
+  static constexpr unsigned char mask = 1;
+  static constexpr unsigned char tag = 1;
+};
+
+// Pointers to scalars, which are never incomplete, get the niche by default.
+// A class may be incomplete where expected<T*, E> is used in one translation
+// unit and complete in another, and the layout must not depend on that, so
+// classes opt in:
+//
+//   template <>
+//   struct rd::niche_traits<node*> : rd::pointer_niche<node> {};
+template <class T>
+requires std::is_scalar_v<T> && (alignof(T) >= 2)
+struct niche_traits<T*> : pointer_niche<T> {};
+
+template <class T>
+requires requires { niche_traits<T*>::offset; } &&
+    (sizeof(std::unique_ptr<T>) == sizeof(T*))
+struct niche_traits<std::unique_ptr<T>> : niche_traits<T*> {};
+
+// Base for niche_traits specializations of enumerations that never use values
+// with the most significant bit of the underlying type set:
+//
+//   template <>
+//   struct rd::niche_traits<my_enum> : rd::enum_niche<my_enum> {};
+template <class Enum>
+requires std::is_enum_v<Enum>
+struct enum_niche {
+  static constexpr std::size_t offset =
+      std::endian::native == std::endian::little ? sizeof(Enum) - 1 : 0;
+  static constexpr unsigned char mask = 1U << (CHAR_BIT - 1);
+  static constexpr unsigned char tag = mask;
+};
+
+// Opt-in trait for types whose objects can be moved to new storage by copying
+// their bytes, without calling the move constructor and the destructor.
+// Trivially copyable types are trivially relocatable; other types can opt in
+// by specializing this trait.
+template <class T>
+struct is_trivially_relocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <class T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <class T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+// Moves the object at source into the uninitialized storage at dest and ends
+// the lifetime of the object at source.
+template <class T>
+constexpr auto relocate_at(T* source, T* dest) noexcept(
+    is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+    -> T* {
+  if constexpr (is_trivially_relocatable_v<T>) {
+    if (!std::is_constant_evaluated()) {
+      std::memcpy(static_cast<void*>(dest), static_cast<void const*>(source),
+                  sizeof(T));
+      return std::launder(dest);
+    }
+  }
+  T* result = std::construct_at(dest, std::move(*source));
+  std::destroy_at(source);
+  return result;
+}
+
 namespace detail {
 template <typename T>
 concept non_void_destructible = std::same_as<T, void> || std::destructible<T>;
@@ -146,58 +400,415 @@ template <detail::non_void_destructible T, std::destructible E>
 class expected;
 
 namespace detail {
+// expected converts to nothing but bool, and explicitly, so only classes,
+// unions and bool can be constructed from one.
+template <typename T>
+concept maybe_constructible_from_expected =
+    std::is_class_v<T> || std::is_union_v<T> ||
+    std::is_same_v<std::remove_cv_t<T>, bool>;
+
+// The traits rather than std::constructible_from and std::convertible_to:
+// they are what std::expected specifies, and each concept costs a handful of
+// instantiations more.
+template <typename T, typename W>
+concept converts_from_any_cvref =
+    std::is_constructible_v<T, W&> || std::is_constructible_v<T, W> ||
+    std::is_constructible_v<T, W const&> ||
+    std::is_constructible_v<T, W const> || std::is_convertible_v<W&, T> ||
+    std::is_convertible_v<W, T> || std::is_convertible_v<W const&, T> ||
+    std::is_convertible_v<W const, T>;
+
+template <typename E, typename W>
+concept unexpected_from_any_cvref =
+    std::is_constructible_v<unexpected<E>, W&> ||
+    std::is_constructible_v<unexpected<E>, W> ||
+    std::is_constructible_v<unexpected<E>, W const&> ||
+    std::is_constructible_v<unexpected<E>, W const>;
+
+// The checks against expected<U, G> are skipped for types that can't be
+// constructed from it anyway, which are most value and error types.
 template <typename T, typename E, typename U, typename G, typename UF,
           typename GF>
 concept expected_constructible_from_other =
-    std::constructible_from<T, UF> &&                                   
-    std::constructible_from<E, GF> &&                                   
-    (!std::constructible_from<T, expected<U, G>&>)&&                    
-    (!std::constructible_from<T, expected<U, G>>)&&                     
-    (!std::constructible_from<T, expected<U, G> const&>)&&              
-    (!std::constructible_from<T, expected<U, G> const>)&&               
-    (!std::convertible_to<expected<U, G>&, T>)&&                        
-    (!std::convertible_to<expected<U, G>&&, T>)&&                       
-    (!std::convertible_to<expected<U, G> const&, T>)&&                  
-    (!std::convertible_to<expected<U, G> const&&, T>)&&                 
-    (!std::constructible_from<unexpected<E>, expected<U, G>&>)&&        
-    (!std::constructible_from<unexpected<E>, expected<U, G>>)&&         
-    (!std::constructible_from<unexpected<E>, expected<U, G> const&>)&&  
-    (!std::constructible_from<unexpected<E>, expected<U, G> const>);
+    std::is_constructible_v<T, UF> && std::is_constructible_v<E, GF> &&
+    (!maybe_constructible_from_expected<T> ||
+     !converts_from_any_cvref<T, expected<U, G>>) &&
+    (!maybe_constructible_from_expected<E> ||
+     !unexpected_from_any_cvref<E, expected<U, G>>);
+
+// Partial specializations rather than comparing T with unexpected<typename
+// T::value_type>, which instantiates a class template per check. References
+// are never unexpected or expected.
+template <typename T>
+inline constexpr bool is_unexpected_v = false;
+
+template <typename E>
+inline constexpr bool is_unexpected_v<unexpected<E>> = true;
+
+template <typename T>
+inline constexpr bool is_expected_v = false;
+
+template <typename T, typename E>
+inline constexpr bool is_expected_v<expected<T, E>> = true;
 
 template <typename T>
 concept is_unexpected =
-    std::same_as<std::remove_cvref_t<T>, unexpected<typename T::value_type>>;
+    !std::is_reference_v<T> && is_unexpected_v<std::remove_cv_t<T>>;
 
 template <typename T>
 concept is_expected =
-    std::same_as<std::remove_cvref_t<T>,
-                 expected<typename T::value_type, typename T::error_type>>;
+    !std::is_reference_v<T> && is_expected_v<std::remove_cv_t<T>>;
+
+// Errors that can record where they passed through: see expected::context.
+template <class E>
+concept context_error = requires(E& e, static_context c) {
+  e.add_context(c);
+};
+
+template <class E, class F>
+concept lazy_context_error = std::invocable<F> &&
+    requires(E& e, std::invoke_result_t<F> ctx) {
+  e.add_context(ctx);
+};
+
+// A niche is only usable if expected can still tell its state apart during
+// constant evaluation, where the niche byte can't be read through the other
+// union member. It asks which member is alive instead: with
+// std::is_within_lifetime where the library has it, otherwise on GCC by
+// whether reading the member's tag byte folds to a constant, which it doesn't
+// for an inactive member. Clang rejects that read outright, so without
+// std::is_within_lifetime it, like other compilers, keeps the flag.
+#if defined(__cpp_lib_is_within_lifetime) || \
+    (defined(__GNUC__) && !defined(__clang__))
+inline constexpr bool niche_supported = true;
+#else
+inline constexpr bool niche_supported = false;
+#endif
+
+constexpr auto read_byte(unsigned char const& byte) noexcept -> bool {
+  unsigned char copy = byte;
+  static_cast<void>(copy);
+  return true;
+}
+
+// Whether member is the alive member of its union. Only meaningful during
+// constant evaluation, and only used where niche_supported.
+template <class Member>
+constexpr auto constant_evaluated_alive(Member const& member) noexcept
+    -> bool {
+#if defined(__cpp_lib_is_within_lifetime)
+  return std::is_within_lifetime(std::addressof(member));
+#elif defined(__GNUC__) && !defined(__clang__)
+  return __builtin_constant_p(read_byte(member.tag()));
+#else
+  static_cast<void>(member);
+  return false;
+#endif
+}
+
+template <class T>
+concept has_niche = niche_supported && requires {
+  { niche_traits<T>::offset } -> std::convertible_to<std::size_t>;
+  { niche_traits<T>::mask } -> std::convertible_to<unsigned char>;
+  { niche_traits<T>::tag } -> std::convertible_to<unsigned char>;
+};
+
+// Decides where the error of expected<T, E> goes inside T's storage so that
+// it doesn't overlap the niche byte: before it if E fits there, otherwise at
+// the first suitably aligned offset after it.
+template <class T, class E>
+struct niche_layout {
+  static constexpr bool enabled = false;
+};
+
+template <class T, class E>
+requires has_niche<T>
+struct niche_layout<T, E> {
+  static constexpr std::size_t tag_offset = niche_traits<T>::offset;
+  static constexpr bool error_first = sizeof(E) <= tag_offset;
+  static constexpr std::size_t error_offset =
+      error_first ? 0 : (tag_offset + alignof(E)) / alignof(E) * alignof(E);
+  static constexpr bool enabled =
+      alignof(E) <= alignof(T) && error_offset + sizeof(E) <= sizeof(T);
+
+  static auto holds_tag(void const* storage) noexcept -> bool {
+    auto const* bytes = static_cast<unsigned char const*>(storage);
+    return (bytes[tag_offset] & niche_traits<T>::mask) == niche_traits<T>::tag;
+  }
+};
+
+// Without a niche in T, the state can live in a niche of E instead, provided
+// that a value of ValueSize bytes ends before E's niche byte. The tag marks
+// the value state then.
+template <std::size_t ValueSize, class E>
+struct error_niche_layout {
+  static constexpr bool enabled = false;
+};
+
+template <std::size_t ValueSize, class E>
+requires has_niche<E> && (ValueSize <= niche_traits<E>::offset)
+struct error_niche_layout<ValueSize, E> {
+  static constexpr std::size_t tag_offset = niche_traits<E>::offset;
+  static constexpr bool enabled = true;
+
+  static auto holds_tag(void const* storage) noexcept -> bool {
+    auto const* bytes = static_cast<unsigned char const*>(storage);
+    return (bytes[tag_offset] & niche_traits<E>::mask) == niche_traits<E>::tag;
+  }
+};
+
+// Stands in for the state flag when the state lives in a niche.
+struct niche_flag {
+  constexpr niche_flag(bool /*unused*/) noexcept {}  // NOLINT
+  constexpr auto operator=(bool /*unused*/) noexcept -> niche_flag& {
+    return *this;
+  }
+};
+
+// Storage for the value alternative of expected<T, E>. With the state in E's
+// niche, the slot also spans E's niche byte and writes the tag into it on
+// construction. For void there is no value, only the tag.
+template <class T, class E>
+struct value_slot {
+  template <class... Args>
+  constexpr explicit value_slot(std::in_place_t /*unused*/,
+                                Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : value(std::forward<Args>(args)...) {}
+
+  T value;
+};
+
+template <class T, class E>
+requires(!niche_layout<T, E>::enabled) &&
+    error_niche_layout<sizeof(T), E>::enabled
+struct value_slot<T, E> {
+  template <class... Args>
+  constexpr explicit value_slot(std::in_place_t /*unused*/,
+                                Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<T, Args...>)
+      : value(std::forward<Args>(args)...) {
+    trail[niche_traits<E>::offset - sizeof(T)] = niche_traits<E>::tag;
+  }
+
+  [[nodiscard]] constexpr auto tag() const noexcept -> unsigned char const& {
+    return trail[niche_traits<E>::offset - sizeof(T)];
+  }
+
+  T value;
+  unsigned char trail[niche_traits<E>::offset - sizeof(T) + 1]{};
+};
+
+template <class E>
+struct value_slot<void, E> {
+  constexpr explicit value_slot(std::in_place_t /*unused*/) noexcept {}
+};
+
+template <class E>
+requires error_niche_layout<0, E>::enabled
+struct value_slot<void, E> {
+  constexpr explicit value_slot(std::in_place_t /*unused*/) noexcept {
+    bytes[niche_traits<E>::offset] = niche_traits<E>::tag;
+  }
+
+  [[nodiscard]] constexpr auto tag() const noexcept -> unsigned char const& {
+    return bytes[niche_traits<E>::offset];
+  }
+
+  unsigned char bytes[niche_traits<E>::offset + 1]{};
+};
+
+// Storage for the error alternative of expected<T, E>. With a niche, the slot
+// also spans T's niche byte and writes the tag into it on construction.
+template <class T, class E>
+struct error_slot {
+  template <class... Args>
+  constexpr explicit error_slot(std::in_place_t /*unused*/, Args&&... args)
+      noexcept(std::is_nothrow_constructible_v<E, Args...>)
+      : error(std::forward<Args>(args)...) {}
+
+  E error;
+};
+
+// The spare bytes are zeroed so that a constexpr expected is fully
+// initialized.
+template <class T, class E>
+requires niche_layout<T, E>::enabled && niche_layout<T, E>::error_first
+struct error_slot<T, E> {
+  template <class... Args>
+  constexpr explicit error_slot(std::in_place_t /*unused*/,
+                                Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<E, Args...>)
+      : error(std::forward<Args>(args)...) {
+    trail[niche_layout<T, E>::tag_offset - sizeof(E)] = niche_traits<T>::tag;
+  }
+
+  [[nodiscard]] constexpr auto tag() const noexcept -> unsigned char const& {
+    return trail[niche_layout<T, E>::tag_offset - sizeof(E)];
+  }
+
+  E error;
+  unsigned char trail[sizeof(T) - sizeof(E)]{};
+};
+
+template <class T, class E>
+requires niche_layout<T, E>::enabled && (!niche_layout<T, E>::error_first)
+struct error_slot<T, E> {
+  template <class... Args>
+  constexpr explicit error_slot(std::in_place_t /*unused*/,
+                                Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<E, Args...>)
+      : error(std::forward<Args>(args)...) {
+    lead[niche_layout<T, E>::tag_offset] = niche_traits<T>::tag;
+  }
+
+  [[nodiscard]] constexpr auto tag() const noexcept -> unsigned char const& {
+    return lead[niche_layout<T, E>::tag_offset];
+  }
+
+  unsigned char lead[niche_layout<T, E>::error_offset]{};
+  E error;
+};
+
+// Constraints of the assignment operators. They are named so that the
+// defaulted trivial overloads subsume them.
+// The traits std::expected specifies, as concepts so that the trivial special
+// members subsume the others. std::copy_constructible and
+// std::move_constructible ask for more and cost more to check.
+template <class T>
+concept copy_constructible = std::is_copy_constructible_v<T>;
+
+template <class T>
+concept move_constructible = std::is_move_constructible_v<T>;
+
+template <class T, class E>
+concept expected_copy_assignable =
+    std::is_copy_assignable_v<T> && std::is_copy_constructible_v<T> &&
+    std::is_copy_assignable_v<E> && std::is_copy_constructible_v<E> &&
+    (std::is_nothrow_move_constructible_v<E> ||
+     std::is_nothrow_move_constructible_v<T>);
+
+template <class T, class E>
+concept expected_move_assignable =
+    std::is_move_constructible_v<T> && std::is_move_assignable_v<T> &&
+    std::is_move_constructible_v<E> && std::is_move_assignable_v<E> &&
+    (std::is_nothrow_move_constructible_v<T> ||
+     std::is_nothrow_move_constructible_v<E>);
+
+template <class E>
+concept void_expected_copy_assignable =
+    std::is_copy_assignable_v<E> && std::is_copy_constructible_v<E>;
+
+template <class E>
+concept void_expected_move_assignable =
+    std::is_move_constructible_v<E> && std::is_move_assignable_v<E>;
+
+// An alternative that can be copied or moved over another by plain byte copy.
+template <class T>
+concept trivially_copy_assignable_alternative =
+    std::is_trivially_copy_constructible_v<T> &&
+    std::is_trivially_copy_assignable_v<T> &&
+    std::is_trivially_destructible_v<T>;
+
+template <class T>
+concept trivially_move_assignable_alternative =
+    std::is_trivially_move_constructible_v<T> &&
+    std::is_trivially_move_assignable_v<T> &&
+    std::is_trivially_destructible_v<T>;
+
+// Bitwise relocation is not available during constant evaluation.
+template <class... Ts>
+constexpr auto relocatable_at_runtime() noexcept -> bool {
+  if constexpr ((is_trivially_relocatable_v<Ts> && ...)) {
+    return !std::is_constant_evaluated();
+  } else {
+    return false;
+  }
+}
+
+// Puts back what a throwing assignment or swap took out, while the exception
+// propagates.
+template <class T, class... Args>
+[[gnu::cold, gnu::noinline]] constexpr void roll_back(T* at, Args&&... args) {
+  std::construct_at(at, std::forward<Args>(args)...);
+}
+
+template <class T>
+[[gnu::cold, gnu::noinline]] constexpr void roll_back_relocation(
+    T* from, T* to) noexcept {
+  relocate_at(from, to);
+}
 
 // This function makes sure expected doesn't get into valueless_by_exception
-// state due to any exception while assignment
+// state due to any exception while assignment. The new value is constructed
+// in place whenever the old one can be stashed without throwing; building it
+// in a temporary costs a move of the new value instead.
 template <class T, class U, class... Args>
 constexpr void reinit_expected(T& newval, U& oldval, Args&&... args) {
-  if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+  // Without exceptions nothing can be rolled back to.
+  if constexpr (std::is_nothrow_constructible_v<T, Args...> ||
+                !exceptions_enabled) {
     std::destroy_at(std::addressof(oldval));
     std::construct_at(std::addressof(newval), std::forward<Args>(args)...);
-  } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
-    T tmp(std::forward<Args>(args)...);
+  } else if (relocatable_at_runtime<U>()) {
+    // stashing the bytes of the old value is enough for rolling back
+    alignas(U) unsigned char buf[sizeof(U)];
+    U* tmp = relocate_at(std::addressof(oldval),
+                         reinterpret_cast<U*>(buf));  // NOLINT
+    RD_EXPECTED_TRY {
+      std::construct_at(std::addressof(newval), std::forward<Args>(args)...);
+    } RD_EXPECTED_CATCH_ALL {
+      roll_back_relocation(tmp, std::addressof(oldval));
+      RD_EXPECTED_RETHROW;
+    }
+    std::destroy_at(tmp);
+  } else if (relocatable_at_runtime<T>()) {
+    // relocating the new value in place of a final move
+    alignas(T) unsigned char buf[sizeof(T)];
+    T* tmp = std::construct_at(reinterpret_cast<T*>(buf),  // NOLINT
+                               std::forward<Args>(args)...);
     std::destroy_at(std::addressof(oldval));
-    std::construct_at(std::addressof(newval), std::move(tmp));
-  } else {
+    relocate_at(tmp, std::addressof(newval));
+  } else if constexpr (std::is_nothrow_move_constructible_v<U> ||
+                       !std::is_nothrow_move_constructible_v<T>) {
     U tmp(std::move(oldval));
     std::destroy_at(std::addressof(oldval));
-    try {
+    RD_EXPECTED_TRY {
       std::construct_at(std::addressof(newval), std::forward<Args>(args)...);
-    } catch (...) {
-      std::construct_at(std::addressof(oldval), std::move(tmp));
-      throw;
+    } RD_EXPECTED_CATCH_ALL {
+      roll_back(std::addressof(oldval), std::move(tmp));
+      RD_EXPECTED_RETHROW;
     }
+  } else {
+    T tmp(std::forward<Args>(args)...);
+    std::destroy_at(std::addressof(oldval));
+    std::construct_at(std::addressof(newval), std::move(tmp));
   }
 }
 
 }  // namespace detail
 
+template <class T, class E>
+struct is_trivially_relocatable<detail::value_slot<T, E>>
+    : is_trivially_relocatable<T> {};
+
+template <class T, class E>
+struct is_trivially_relocatable<detail::error_slot<T, E>>
+    : is_trivially_relocatable<E> {};
+
+template <class T, class E>
+struct is_trivially_relocatable<expected<T, E>>
+    : std::bool_constant<is_trivially_relocatable_v<T> &&
+                         is_trivially_relocatable_v<E>> {};
+
+template <class E>
+struct is_trivially_relocatable<expected<void, E>>
+    : is_trivially_relocatable<E> {};
+
+template <class T, class E>
+struct is_trivially_relocatable<expected<T&, E>>
+    : is_trivially_relocatable<E> {};
+
 template <detail::non_void_destructible T, std::destructible E>
 class expected {
  public:
@@ -210,30 +821,36 @@ class expected {
 
   // constructors
   // postcondition: has_value() = true
-  constexpr expected() requires std::default_initializable<T> : val{} {};
+  constexpr expected() requires std::is_default_constructible_v<T>
+      : val(std::in_place) {
+    set_has_value(true);
+  }
 
   // postcondition: has_value() = rhs.has_value()
   constexpr expected(expected const& rhs)
-      requires std::copy_constructible<T> && std::copy_constructible<E> &&
+      requires detail::copy_constructible<T> &&
+      detail::copy_constructible<E> &&
       std::is_trivially_copy_constructible_v<T> &&
       std::is_trivially_copy_constructible_v<E>
   = default;
 
   // postcondition: has_value() = rhs.has_value()
   constexpr expected(expected const& rhs)
-      requires std::copy_constructible<T> && std::copy_constructible<E>
+      requires detail::copy_constructible<T> && detail::copy_constructible<E>
       : has_val(rhs.has_val) {
     if (rhs.has_value()) {
-      std::construct_at(std::addressof(this->val), *rhs);
+      std::construct_at(std::addressof(this->val), std::in_place, *rhs);
+      set_has_value(true);
     } else {
-      std::construct_at(std::addressof(this->unex), rhs.error());
+      std::construct_at(std::addressof(this->unex), std::in_place,
+                        rhs.error());
     }
   }
 
   constexpr expected(expected&&) noexcept(
       std::is_nothrow_move_constructible_v<T>&&
           std::is_nothrow_move_constructible_v<E>) requires
-      std::move_constructible<T> && std::move_constructible<E> &&
+      detail::move_constructible<T> && detail::move_constructible<E> &&
       std::is_trivially_move_constructible_v<T> &&
       std::is_trivially_move_constructible_v<E>
   = default;
@@ -241,12 +858,15 @@ class expected {
   constexpr expected(expected&& rhs) noexcept(
       std::is_nothrow_move_constructible_v<T>&&
           std::is_nothrow_move_constructible_v<E>) requires
-      std::move_constructible<T> && std::move_constructible<E>
+      detail::move_constructible<T> && detail::move_constructible<E>
       : has_val(rhs.has_value()) {
     if (rhs.has_value()) {
-      std::construct_at(std::addressof(this->val), std::move(*rhs));
+      std::construct_at(std::addressof(this->val), std::in_place,
+                        std::move(*rhs));
+      set_has_value(true);
     } else {
-      std::construct_at(std::addressof(this->unex), std::move(rhs.error()));
+      std::construct_at(std::addressof(this->unex), std::in_place,
+                        std::move(rhs.error()));
     }
   }
 
@@ -260,9 +880,11 @@ class expected {
     using UF = U const&;
     using GF = G const&;
     if (rhs.has_value()) {
-      std::construct_at(std::addressof(this->val), std::forward<UF>(*rhs));
+      std::construct_at(std::addressof(this->val), std::in_place,
+                        std::forward<UF>(*rhs));
+      set_has_value(true);
     } else {
-      std::construct_at(std::addressof(this->unex),
+      std::construct_at(std::addressof(this->unex), std::in_place,
                         std::forward<GF>(rhs.error()));
     }
   }
@@ -272,12 +894,14 @@ class expected {
   constexpr explicit(!std::convertible_to<U, T> || !std::convertible_to<G, E>)
       expected(expected<U, G>&& rhs)  // NOLINT
       : has_val(rhs.has_value()) {
-    using UF = U const&;
-    using GF = G const&;
+    using UF = U;
+    using GF = G;
     if (rhs.has_value()) {
-      std::construct_at(std::addressof(this->val), std::forward<UF>(*rhs));
+      std::construct_at(std::addressof(this->val), std::in_place,
+                        std::forward<UF>(*rhs));
+      set_has_value(true);
     } else {
-      std::construct_at(std::addressof(this->unex),
+      std::construct_at(std::addressof(this->unex), std::in_place,
                         std::forward<GF>(rhs.error()));
     }
   }
@@ -288,36 +912,43 @@ class expected {
       (!detail::is_unexpected<U>)&&                                    
       std::constructible_from<T, U>                                    
   constexpr explicit(!std::convertible_to<U, T>) expected(U&& v)   // NOLINT
-      : val(std::forward<U>(v)) {}
+      : val(std::in_place, std::forward<U>(v)) {
+    set_has_value(true);
+  }
 
   template <class G>
   requires std::constructible_from<E, G const&>
   constexpr explicit(!std::convertible_to<G const&, E>)
       expected(unexpected<G> const& e)  // NOLINT
-      : has_val{false}, unex(std::forward<G const&>(e.value())) {}
+      : has_val{false},
+        unex(std::in_place, std::forward<G const&>(e.value())) {}
 
   template <class G>
   requires std::constructible_from<E, G>
   constexpr explicit(!std::convertible_to<G, E>)
       expected(unexpected<G>&& e)  // NOLINT
-      : has_val{false}, unex(std::forward<G>(e.value())) {}
+      : has_val{false}, unex(std::in_place, std::forward<G>(e.value())) {}
 
   template <class... Args>
   requires std::constructible_from<T, Args...>
   constexpr explicit expected(std::in_place_t /*unused*/, Args&&... args)
-      : val(std::forward<Args>(args)...) {}
+      : val(std::in_place, std::forward<Args>(args)...) {
+    set_has_value(true);
+  }
 
   template <class U, class... Args>
   requires std::constructible_from < T, std::initializer_list<U>
   &, Args... > constexpr explicit expected(std::in_place_t /*unused*/,
                                            std::initializer_list<U> il,
                                            Args&&... args)
-      : val(il, std::forward<Args>(args)...) {}
+      : val(std::in_place, il, std::forward<Args>(args)...) {
+    set_has_value(true);
+  }
 
   template <class... Args>
   requires std::constructible_from<E, Args...>
   constexpr explicit expected(unexpect_t /*unused*/, Args&&... args)
-      : has_val{false}, unex(std::forward<Args>(args)...) {}
+      : has_val{false}, unex(std::in_place, std::forward<Args>(args)...) {}
 
   template <class U, class... Args>
   requires std::constructible_from < E, std::initializer_list<U>
@@ -326,22 +957,24 @@ class expected {
                                             std::initializer_list<U> il,
                                             Args&&... args)
       : has_val(false),
-  unex(il, std::forward<Args>(args)...) {}
+  unex(std::in_place, il, std::forward<Args>(args)...) {}
 
   // destructor
+  constexpr ~expected() requires std::is_trivially_destructible_v<T> &&
+      std::is_trivially_destructible_v<E>
+  = default;
+
   constexpr ~expected() {
-    if constexpr (std::is_trivially_destructible_v<T> and
-                  std::is_trivially_destructible_v<E>) {
-    } else if constexpr (std::is_trivially_destructible_v<T>) {
-      if (!has_val) {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+      if (!has_value()) {
         std::destroy_at(std::addressof(this->unex));
       }
     } else if constexpr (std::is_trivially_destructible_v<E>) {
-      if (has_val) {
+      if (has_value()) {
         std::destroy_at(std::addressof(this->val));
       }
     } else {
-      if (has_val) {
+      if (has_value()) {
         std::destroy_at(std::addressof(this->val));
       } else {
         std::destroy_at(std::addressof(this->unex));
@@ -350,48 +983,52 @@ class expected {
   }
 
   // assignment
-  constexpr auto operator=(expected const& rhs)              // NOLINT
-      -> expected& requires std::is_copy_assignable_v<T> &&  
-      std::is_copy_constructible_v<T> &&                     
-      std::is_copy_assignable_v<E> &&                        
-      std::is_copy_constructible_v<E> &&                     
-      (std::is_nothrow_move_constructible_v<E> ||            
-       std::is_nothrow_move_constructible_v<T>)              
-  {
+  constexpr auto operator=(expected const&) -> expected&  // NOLINT
+      requires detail::expected_copy_assignable<T, E> &&
+      detail::trivially_copy_assignable_alternative<T> &&
+      detail::trivially_copy_assignable_alternative<E>
+  = default;
+
+  constexpr auto operator=(expected const& rhs) -> expected&  // NOLINT
+      requires detail::expected_copy_assignable<T, E> {
     if (this->has_value() and rhs.has_value()) {
-      this->val = *rhs;
+      this->val.value = *rhs;
     } else if (this->has_value()) {
-      detail::reinit_expected(this->unex, this->val, rhs.error());
+      detail::reinit_expected(this->unex, this->val, std::in_place,
+                              rhs.error());
     } else if (rhs.has_value()) {
-      detail::reinit_expected(this->val, this->unex, *rhs);
+      detail::reinit_expected(this->val, this->unex, std::in_place, *rhs);
     } else {
-      this->unex = rhs.error();
+      this->unex.error = rhs.error();
     }
-    has_val = rhs.has_value();
+    set_has_value(rhs.has_value());
     return *this;
   }
 
+  constexpr auto operator=(expected&&) noexcept -> expected&  // NOLINT
+      requires detail::expected_move_assignable<T, E> &&
+      detail::trivially_move_assignable_alternative<T> &&
+      detail::trivially_move_assignable_alternative<E>
+  = default;
+
   constexpr auto operator=(expected&& rhs)  //
       noexcept(std::is_nothrow_move_assignable_v<T>&&
                std::is_nothrow_move_constructible_v<T>&&
                std::is_nothrow_move_assignable_v<E>&&
                std::is_nothrow_move_constructible_v<E>)
-          -> expected& requires std::is_move_constructible_v<T> &&
-      std::is_move_assignable_v<T> &&                             
-      std::is_move_constructible_v<E> &&                          
-      std::is_move_assignable_v<E> &&                             
-      (std::is_nothrow_move_constructible_v<T> || std::is_nothrow_move_constructible_v<E>)
-  {
+          -> expected& requires detail::expected_move_assignable<T, E> {
     if (this->has_value() and rhs.has_value()) {
-      this->val = std::move(*rhs);
+      this->val.value = std::move(*rhs);
     } else if (this->has_value()) {
-      detail::reinit_expected(this->unex, this->val, std::move(rhs.error()));
+      detail::reinit_expected(this->unex, this->val, std::in_place,
+                              std::move(rhs.error()));
     } else if (rhs.has_value()) {
-      detail::reinit_expected(this->val, this->unex, std::move(*rhs));
+      detail::reinit_expected(this->val, this->unex, std::in_place,
+                              std::move(*rhs));
     } else {
-      this->unex = std::move(rhs.error());
+      this->unex.error = std::move(rhs.error());
     }
-    has_val = rhs.has_value();
+    set_has_value(rhs.has_value());
     return *this;
   }
 
@@ -407,11 +1044,12 @@ class expected {
         std::is_nothrow_move_constructible_v<E>                 
       ) {
     if (this->has_value()) {
-      this->val = std::forward<U>(rhs);
+      this->val.value = std::forward<U>(rhs);
       return *this;
     }
-    detail::reinit_expected(this->val, this->unex, std::forward<U>(rhs));
-    has_val = true;
+    detail::reinit_expected(this->val, this->unex, std::in_place,
+                            std::forward<U>(rhs));
+    set_has_value(true);
     return *this;
   }
 
@@ -425,12 +1063,12 @@ class expected {
   constexpr auto operator=(unexpected<G> const& e) -> expected& {
     using GF = G const&;
     if (has_value()) {
-      detail::reinit_expected(this->unex, this->val,
+      detail::reinit_expected(this->unex, this->val, std::in_place,
                               std::forward<GF>(e.value()));
     } else {
-      this->unex = std::forward<GF>(e.value());
+      this->unex.error = std::forward<GF>(e.value());
     }
-    has_val = false;
+    set_has_value(false);
     return *this;
   }
 
@@ -444,12 +1082,12 @@ class expected {
   constexpr auto operator=(unexpected<G>&& e) -> expected& {
     using GF = G;
     if (has_value()) {
-      detail::reinit_expected(this->unex, this->val,
+      detail::reinit_expected(this->unex, this->val, std::in_place,
                               std::forward<GF>(e.value()));
     } else {
-      this->unex = std::forward<GF>(e.value());
+      this->unex.error = std::forward<GF>(e.value());
     }
-    has_val = false;
+    set_has_value(false);
     return *this;
   }
 
@@ -461,10 +1099,11 @@ class expected {
       std::destroy_at(std::addressof(this->val));
     } else {
       std::destroy_at(std::addressof(this->unex));
-      has_val = true;
+      set_has_value(true);
     }
-    return *std::construct_at(std::addressof(this->val),
-                              std::forward<Args>(args)...);
+    return std::construct_at(std::addressof(this->val), std::in_place,
+                             std::forward<Args>(args)...)
+        ->value;
   }
 
   template <class U, class... Args>
@@ -475,15 +1114,16 @@ class expected {
       std::destroy_at(std::addressof(this->val));
     } else {
       std::destroy_at(std::addressof(this->unex));
-      has_val = true;
+      set_has_value(true);
     }
-    return *std::construct_at(std::addressof(this->val), il,
-                              std::forward<Args>(args)...);
+    return std::construct_at(std::addressof(this->val), std::in_place, il,
+                             std::forward<Args>(args)...)
+        ->value;
   }
 
   // swap
   constexpr void swap(expected& rhs) noexcept(
-      std::is_nothrow_constructible_v<T>&&
+      std::is_nothrow_move_constructible_v<T>&&
       std::is_nothrow_swappable_v<T>&&
       std::is_nothrow_move_constructible_v<E>&&
       std::is_nothrow_swappable_v<E>)
@@ -491,46 +1131,67 @@ class expected {
       std::is_swappable_v<E> &&                       
       std::is_move_constructible_v<T> &&              
       std::is_move_constructible_v<E> &&              
-      (std::is_nothrow_constructible_v<T> ||          
-       std::is_nothrow_constructible_v<E>)            
+      (std::is_nothrow_move_constructible_v<T> ||     
+       std::is_nothrow_move_constructible_v<E>)       
   {
     if (rhs.has_value()) {
       if (has_value()) {
         using std::swap;
-        swap(this->val, rhs.val);
+        swap(this->val.value, rhs.val.value);
       } else {
         rhs.swap(*this);
       }
     } else {
       if (has_value()) {
-        if constexpr (std::is_nothrow_move_constructible_v<E>) {
-          E tmp(std::move(rhs.unex));
+        if (detail::relocatable_at_runtime<T, E>()) {
+          using value_slot = detail::value_slot<T, E>;
+          alignas(value_slot) unsigned char buf[sizeof(value_slot)];
+          value_slot* tmp = relocate_at(
+              std::addressof(this->val),
+              reinterpret_cast<value_slot*>(buf));  // NOLINT
+          relocate_at(std::addressof(rhs.unex), std::addressof(this->unex));
+          relocate_at(tmp, std::addressof(rhs.val));
+        } else if constexpr ((std::is_nothrow_move_constructible_v<T> &&
+                              std::is_nothrow_move_constructible_v<E>) ||
+                             !detail::exceptions_enabled) {
+          E tmp(std::move(rhs.unex.error));
+          std::destroy_at(std::addressof(rhs.unex));
+          std::construct_at(std::addressof(rhs.val), std::move(this->val));
+          std::destroy_at(std::addressof(this->val));
+          std::construct_at(std::addressof(this->unex), std::in_place,
+                            std::move(tmp));
+        } else if constexpr (std::is_nothrow_move_constructible_v<E>) {
+          E tmp(std::move(rhs.unex.error));
           std::destroy_at(std::addressof(rhs.unex));
-          try {
+          RD_EXPECTED_TRY {
             std::construct_at(std::addressof(rhs.val), std::move(this->val));
             std::destroy_at(std::addressof(this->val));
-            std::construct_at(std::addressof(this->unex), std::move(tmp));
-          } catch (...) {
-            std::construct_at(std::addressof(rhs.unex), std::move(tmp));
-            throw;
+            std::construct_at(std::addressof(this->unex), std::in_place,
+                              std::move(tmp));
+          } RD_EXPECTED_CATCH_ALL {
+            detail::roll_back(std::addressof(rhs.unex), std::in_place,
+                              std::move(tmp));
+            RD_EXPECTED_RETHROW;
           }
         } else {
-          T tmp(std::move(this->val));
+          T tmp(std::move(this->val.value));
           std::destroy_at(std::addressof(this->val));
-          try {
+          RD_EXPECTED_TRY {
             std::construct_at(std::addressof(this->unex), std::move(rhs.unex));
             std::destroy_at(std::addressof(rhs.unex));
-            std::construct_at(std::addressof(rhs.val), std::move(tmp));
-          } catch (...) {
-            std::construct_at(std::addressof(this->val), std::move(tmp));
-            throw;
+            std::construct_at(std::addressof(rhs.val), std::in_place,
+                              std::move(tmp));
+          } RD_EXPECTED_CATCH_ALL {
+            detail::roll_back(std::addressof(this->val), std::in_place,
+                              std::move(tmp));
+            RD_EXPECTED_RETHROW;
           }
         }
-        has_val = false;
-        rhs.has_val = true;
+        set_has_value(false);
+        rhs.set_has_value(true);
       } else {
         using std::swap;
-        swap(this->unex, rhs.unex);
+        swap(this->unex.error, rhs.unex.error);
       }
     }
   }
@@ -539,73 +1200,119 @@ class expected {
 
   // precondition: has_value() = true
   constexpr auto operator->() const noexcept -> T const* {
-    return std::addressof(this->val);
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator-> on an expected without a value");
+    return std::addressof(this->val.value);
   }
 
   // precondition: has_value() = true
   constexpr auto operator->() noexcept -> T* {
-    return std::addressof(this->val);
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator-> on an expected without a value");
+    return std::addressof(this->val.value);
   }
 
   // precondition: has_value() = true
-  constexpr auto operator*() const& noexcept -> T const& { return this->val; }
+  constexpr auto operator*() const& noexcept -> T const& {
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator* on an expected without a value");
+    return this->val.value;
+  }
 
   // precondition: has_value() = true
-  constexpr auto operator*() & noexcept -> T& { return this->val; }
+  constexpr auto operator*() & noexcept -> T& {
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator* on an expected without a value");
+    return this->val.value;
+  }
 
   // precondition: has_value() = true
   constexpr auto operator*() const&& noexcept -> T const&& {
-    return std::move(this->val);
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator* on an expected without a value");
+    return std::move(this->val.value);
   }
 
   // precondition: has_value() = true
-  constexpr auto operator*() && noexcept -> T&& { return std::move(this->val); }
+  constexpr auto operator*() && noexcept -> T&& {
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator* on an expected without a value");
+    return std::move(this->val.value);
+  }
 
-  constexpr explicit operator bool() const noexcept { return has_val; }
+  constexpr explicit operator bool() const noexcept { return has_value(); }
 
   [[nodiscard]] constexpr auto has_value() const noexcept -> bool {
-    return has_val;
+    if constexpr (niche::enabled) {
+      if (std::is_constant_evaluated()) {
+        return !detail::constant_evaluated_alive(this->unex);
+      }
+      return !niche::holds_tag(std::addressof(this->val));
+    } else if constexpr (error_niche::enabled) {
+      if (std::is_constant_evaluated()) {
+        return detail::constant_evaluated_alive(this->val);
+      }
+      return error_niche::holds_tag(std::addressof(this->val));
+    } else {
+      return has_val;
+    }
   }
 
   constexpr auto value() const& -> T const& {
-    if (has_value()) {
-      return this->val;
+    if (has_value()) [[likely]] {
+      return this->val.value;
     }
-    throw bad_expected_access(error());
+    detail::throw_bad_expected_access(error());
   }
 
   constexpr auto value() & -> T& {
-    if (has_value()) {
-      return this->val;
+    if (has_value()) [[likely]] {
+      return this->val.value;
     }
-    throw bad_expected_access(error());
+    detail::throw_bad_expected_access(error());
   }
 
   constexpr auto value() const&& -> T const&& {
-    if (has_value()) {
-      return std::move(this->val);
+    if (has_value()) [[likely]] {
+      return std::move(this->val.value);
     }
-    throw bad_expected_access(std::move(error()));
+    detail::throw_bad_expected_access(std::move(error()));
   }
 
   constexpr auto value() && -> T&& {
-    if (has_value()) {
-      return std::move(this->val);
+    if (has_value()) [[likely]] {
+      return std::move(this->val.value);
     }
-    throw bad_expected_access(std::move(error()));
+    detail::throw_bad_expected_access(std::move(error()));
   }
 
   // precondition: has_value() = false
-  constexpr auto error() const& -> E const& { return this->unex; }
+  constexpr auto error() const& -> E const& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return this->unex.error;
+  }
 
   // precondition: has_value() = false
-  constexpr auto error() & -> E& { return this->unex; }
+  constexpr auto error() & -> E& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return this->unex.error;
+  }
 
   // precondition: has_value() = false
-  constexpr auto error() const&& -> E const&& { return std::move(this->unex); }
+  constexpr auto error() const&& -> E const&& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return std::move(this->unex.error);
+  }
 
   // precondition: has_value() = false
-  constexpr auto error() && -> E&& { return std::move(this->unex); }
+  constexpr auto error() && -> E&& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return std::move(this->unex.error);
+  }
 
   template <class U>
   requires 
@@ -627,7 +1334,7 @@ class expected {
       std::is_copy_constructible_v<E> && std::is_copy_constructible_v<T>
   constexpr auto and_then(F&& f) & {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f), **this);
+      return detail::invoke(std::forward<F>(f), **this);
     }
     return U(unexpect, error());
   }
@@ -640,7 +1347,7 @@ class expected {
       std::is_copy_constructible_v<T>
   constexpr auto and_then(F&& f) const& {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f), **this);
+      return detail::invoke(std::forward<F>(f), **this);
     }
     return U(unexpect, error());
   }
@@ -653,7 +1360,7 @@ class expected {
       std::is_move_constructible_v<T>
   constexpr auto and_then(F&& f) && {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f), std::move(**this));
+      return detail::invoke(std::forward<F>(f), std::move(**this));
     }
     return U(unexpect, std::move(error()));
   }
@@ -666,7 +1373,7 @@ class expected {
       std::is_move_constructible_v<T>
   constexpr auto and_then(F&& f) const&& {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f), std::move(**this));
+      return detail::invoke(std::forward<F>(f), std::move(**this));
     }
     return U(unexpect, std::move(error()));
   }
@@ -681,7 +1388,7 @@ class expected {
     if (has_value()) {
       return G(**this);
     }
-    return std::invoke(std::forward<F>(f), error());
+    return detail::invoke(std::forward<F>(f), error());
   }
 
   template <class F, class V = E const&,
@@ -694,7 +1401,7 @@ class expected {
     if (has_value()) {
       return G(**this);
     }
-    return std::invoke(std::forward<F>(f), error());
+    return detail::invoke(std::forward<F>(f), error());
   }
 
   template <class F, class V = E&&,
@@ -707,7 +1414,7 @@ class expected {
     if (has_value()) {
       return G(std::move(**this));
     }
-    return std::invoke(std::forward<F>(f), std::move(error()));
+    return detail::invoke(std::forward<F>(f), std::move(error()));
   }
 
   template <class F, class V = E const&&,
@@ -720,7 +1427,7 @@ class expected {
     if (has_value()) {
       return G(std::move(**this));
     }
-    return std::invoke(std::forward<F>(f), std::move(error()));
+    return detail::invoke(std::forward<F>(f), std::move(error()));
   }
 
   template <class F, class V = E&,
@@ -732,7 +1439,7 @@ class expected {
     if (has_value()) {
       return expected(*this);
     }
-    std::invoke(std::forward<F>(f), error());
+    detail::invoke(std::forward<F>(f), error());
     return expected(*this);
   }
 
@@ -745,38 +1452,32 @@ class expected {
     if (has_value()) {
       return expected(*this);
     }
-    std::invoke(std::forward<F>(f), error());
+    detail::invoke(std::forward<F>(f), error());
     return expected(*this);
   }
 
-  template <class F, class V = E&&,
+  template <class F, class V = E&,
             class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
   requires std::is_void_v<G> &&
            std::is_move_constructible_v<T> &&
-           std::is_move_constructible_v<E> &&
-           std::is_copy_constructible_v<E>
+           std::is_move_constructible_v<E>
   constexpr auto or_else(F&& f) && {
-    if (has_value()) {
-      return expected(std::move(*this));
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
     }
-    // TODO: is this copy necessary, as f can be just read argument function
-    std::invoke(std::forward<F>(f), error());
     return expected(std::move(*this));
   }
 
-  template <class F, class V = E const&&,
+  template <class F, class V = E const&,
             class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
   requires std::is_void_v<G> &&
-           std::is_move_constructible_v<T> &&
-           std::is_move_constructible_v<E> &&
+           std::is_copy_constructible_v<T> &&
            std::is_copy_constructible_v<E>
   constexpr auto or_else(F&& f) const&& {
     if (!has_value()) {
-      return expected(std::move(*this));
+      detail::invoke(std::forward<F>(f), error());
     }
-    // TODO: is this copy necessary, as f can be just read argument function
-    std::invoke(std::forward<F>(f), error());
-    return expected(std::move(*this));
+    return expected(*this);
   }
 
   template <class F, class V = T&,
@@ -786,9 +1487,9 @@ class expected {
   constexpr auto transform(F&& f) & {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
-        return expected<U, E>(std::invoke(std::forward<F>(f), **this));
+        return expected<U, E>(detail::invoke(std::forward<F>(f), **this));
       } else {
-        std::invoke(std::forward<F>(f), std::move(**this));
+        detail::invoke(std::forward<F>(f), **this);
         return expected<U, E>();
       }
     }
@@ -802,9 +1503,9 @@ class expected {
   constexpr auto transform(F&& f) const& {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
-        return expected<U, E>(std::invoke(std::forward<F>(f), **this));
+        return expected<U, E>(detail::invoke(std::forward<F>(f), **this));
       } else {
-        std::invoke(std::forward<F>(f), std::move(**this));
+        detail::invoke(std::forward<F>(f), **this);
         return expected<U, E>();
       }
     }
@@ -819,9 +1520,9 @@ class expected {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
         return expected<U, E>(
-            std::invoke(std::forward<F>(f), std::move(**this)));
+            detail::invoke(std::forward<F>(f), std::move(**this)));
       } else {
-        std::invoke(std::forward<F>(f), std::move(**this));
+        detail::invoke(std::forward<F>(f), std::move(**this));
         return expected<U, E>();
       }
     }
@@ -836,9 +1537,9 @@ class expected {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
         return expected<U, E>(
-            std::invoke(std::forward<F>(f), std::move(**this)));
+            detail::invoke(std::forward<F>(f), std::move(**this)));
       } else {
-        std::invoke(std::forward<F>(f), std::move(**this));
+        detail::invoke(std::forward<F>(f), std::move(**this));
         return expected<U, E>();
       }
     }
@@ -853,7 +1554,7 @@ class expected {
     if (has_value()) {
       return expected<T, G>(**this);
     }
-    return expected<T, G>(unexpect, std::invoke(std::forward<F>(f), error()));
+    return expected<T, G>(unexpect, detail::invoke(std::forward<F>(f), error()));
   }
 
   template <class F, class V = E const&,
@@ -864,7 +1565,7 @@ class expected {
     if (has_value()) {
       return expected<T, G>(**this);
     }
-    return expected<T, G>(unexpect, std::invoke(std::forward<F>(f), error()));
+    return expected<T, G>(unexpect, detail::invoke(std::forward<F>(f), error()));
   }
 
   template <class F, class V = E&&,
@@ -876,7 +1577,7 @@ class expected {
       return expected<T, G>(std::move(**this));
     }
     return expected<T, G>(unexpect,
-                          std::invoke(std::forward<F>(f), std::move(error())));
+                          detail::invoke(std::forward<F>(f), std::move(error())));
   }
 
   template <class F, class V = E const&&,
@@ -888,53 +1589,248 @@ class expected {
       return expected<T, G>(std::move(**this));
     }
     return expected<T, G>(unexpect,
-                          std::invoke(std::forward<F>(f), std::move(error())));
+                          detail::invoke(std::forward<F>(f), std::move(error())));
   }
 
-  // equality operators
-  template <class T2, class E2>
-  requires(!std::is_void_v<T2>) &&
-      requires(T const& t1, T2 const& t2, E const& e1, E2 const& e2) {
-    { t1 == t2 } -> std::convertible_to<bool>;
-    { e1 == e2 } -> std::convertible_to<bool>;
+  // inspect, inspect_error: f observes the value or the error through a
+  // const reference, and *this is passed on as it is, without a copy. For
+  // logging and metrics in a chain.
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) & -> expected& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
+    }
+    return *this;
   }
-  friend constexpr auto operator==(expected const& x, expected<T2, E2> const& y)
-      -> bool {
-    if (x.has_value() != y.has_value()) {
-      return false;
+
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) const& -> expected const& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
     }
-    return x.has_value() ? (*x == *y) : (x.error() == y.error());
+    return *this;
   }
 
-  template <class T2>
-  requires(!detail::is_expected<T2>) && requires(T const& x, T2 const& v) {
-    { x == v } -> std::convertible_to<bool>;
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) && -> expected&& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
+    }
+    return std::move(*this);
   }
-  friend constexpr auto operator==(expected const& x, T2 const& v) -> bool {
-    return x.has_value() && static_cast<bool>(*x == v);
+
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) const&& -> expected const&& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
+    }
+    return std::move(*this);
   }
 
-  template <class E2>
-  requires requires(E const& x, unexpected<E2> const& e) {
-    { x == e.value() } -> std::convertible_to<bool>;
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) & -> expected& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return *this;
   }
-  friend constexpr auto operator==(expected const& x, unexpected<E2> const& e)
-      -> bool {
-    return !x.has_value() && static_cast<bool>(x.error() == e.value());
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) const& -> expected const& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return *this;
   }
 
-  // specialized algorithms
-  friend constexpr void swap(expected& x,
-                             expected& y) noexcept(noexcept(x.swap(y))) {
-    x.swap(y);
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) && -> expected&& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return std::move(*this);
   }
 
- private:
-  bool has_val{true};
-  union {
-    T val;
-    E unex;
-  };
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) const&& -> expected const&& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return std::move(*this);
+  }
+
+  // Mutating counterparts of transform, transform_error and and_then: they
+  // update *this instead of making a new expected, so the value isn't moved
+  // around when the type stays the same. The && overloads return *this as an
+  // rvalue; keep the result of a chain on a temporary by value.
+
+  // transform_inplace: f(value&) updates the value where it is.
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, T&>>
+  constexpr auto transform_inplace(F&& f) & -> expected& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), **this);
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, T&>>
+  constexpr auto transform_inplace(F&& f) && -> expected&& {
+    return std::move(transform_inplace(std::forward<F>(f)));
+  }
+
+  // transform_error_inplace: f(error&) updates the error where it is.
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, E&>>
+  constexpr auto transform_error_inplace(F&& f) & -> expected& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, E&>>
+  constexpr auto transform_error_inplace(F&& f) && -> expected&& {
+    return std::move(transform_error_inplace(std::forward<F>(f)));
+  }
+
+  // and_then_inplace: f(value&) updates the value and returns an
+  // expected<void, E>; its error replaces the value.
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F, T&>>>
+  requires detail::is_expected<U> && std::is_void_v<typename U::value_type> &&
+      std::is_same_v<typename U::error_type, E> &&
+      std::is_move_constructible_v<E>
+  constexpr auto and_then_inplace(F&& f) & -> expected& {
+    if (has_value()) {
+      auto r = detail::invoke(std::forward<F>(f), **this);
+      if (!r.has_value()) {
+        detail::reinit_expected(this->unex, this->val, std::in_place,
+                                std::move(r).error());
+        set_has_value(false);
+      }
+    }
+    return *this;
+  }
+
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F, T&>>>
+  requires detail::is_expected<U> && std::is_void_v<typename U::value_type> &&
+      std::is_same_v<typename U::error_type, E> &&
+      std::is_move_constructible_v<E>
+  constexpr auto and_then_inplace(F&& f) && -> expected&& {
+    return std::move(and_then_inplace(std::forward<F>(f)));
+  }
+
+  // context: records c on the error, if any. Frames are a pointer to static
+  // text, so this is cheap for errors that keep them inline (see
+  // rd::error_chain).
+  template <class G = E>
+  requires detail::context_error<G>
+  constexpr auto context(static_context c) & -> expected& {
+    if (!has_value()) {
+      error().add_context(c);
+    }
+    return *this;
+  }
+
+  template <class G = E>
+  requires detail::context_error<G>
+  constexpr auto context(static_context c) && -> expected {
+    if (!has_value()) {
+      error().add_context(c);
+    }
+    return std::move(*this);
+  }
+
+  // with_context: like context, but f builds the frame and is only invoked
+  // on error.
+  template <class F>
+  requires detail::lazy_context_error<E, F>
+  constexpr auto with_context(F&& f) & -> expected& {
+    if (!has_value()) {
+      error().add_context(detail::invoke(std::forward<F>(f)));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires detail::lazy_context_error<E, F>
+  constexpr auto with_context(F&& f) && -> expected {
+    if (!has_value()) {
+      error().add_context(detail::invoke(std::forward<F>(f)));
+    }
+    return std::move(*this);
+  }
+
+  // equality operators
+  template <class T2, class E2>
+  requires(!std::is_void_v<T2>) &&
+      requires(T const& t1, T2 const& t2, E const& e1, E2 const& e2) {
+    { t1 == t2 } -> std::convertible_to<bool>;
+    { e1 == e2 } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(expected const& x, expected<T2, E2> const& y)
+      -> bool {
+    if (x.has_value() != y.has_value()) {
+      return false;
+    }
+    return x.has_value() ? (*x == *y) : (x.error() == y.error());
+  }
+
+  // Self is deduced so that no conversion to expected is considered: it would
+  // make the constraint on T == T2 depend on itself.
+  template <class Self, class T2>
+  requires std::same_as<Self, expected> && (!detail::is_expected<T2>) &&
+      requires(T const& x, T2 const& v) {
+    { x == v } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(Self const& x, T2 const& v) -> bool {
+    return x.has_value() && static_cast<bool>(*x == v);
+  }
+
+  template <class E2>
+  requires requires(E const& x, unexpected<E2> const& e) {
+    { x == e.value() } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(expected const& x, unexpected<E2> const& e)
+      -> bool {
+    return !x.has_value() && static_cast<bool>(x.error() == e.value());
+  }
+
+  // specialized algorithms
+  friend constexpr void swap(expected& x,
+                             expected& y) noexcept(noexcept(x.swap(y))) {
+    x.swap(y);
+  }
+
+ private:
+  using niche = detail::niche_layout<T, E>;
+  // A value never fits before E's niche byte when T's niche is in use.
+  using error_niche =
+      detail::error_niche_layout<niche::enabled ? sizeof(E) : sizeof(T), E>;
+
+  // The value slot writes the tag of E's niche itself.
+  constexpr void set_has_value(bool v) noexcept { has_val = v; }
+
+  // When T has a niche that E fits beside, or E has a niche that T fits
+  // before, the state lives in the storage and this member takes no space.
+  [[no_unique_address]] std::conditional_t<niche::enabled ||
+                                               error_niche::enabled,
+                                           detail::niche_flag, bool>
+      has_val{true};
+  union {
+    detail::value_slot<T, E> val;
+    detail::error_slot<T, E> unex;
+  };
 };
 
 template <std::destructible E>
@@ -950,30 +1846,33 @@ class expected<void, E> {
   // constructors
 
   // postcondition: has_value() = true
-  constexpr expected() noexcept {}  // NOLINT
+  constexpr expected() noexcept { set_has_value(true); }  // NOLINT
 
-  constexpr expected(
-      expected const& rhs) requires std::is_copy_constructible_v<E> &&
+  constexpr expected(expected const& rhs)
+      requires detail::copy_constructible<E> &&
       std::is_trivially_copy_constructible_v<E>
   = default;
 
-  constexpr expected(
-      expected const& rhs) requires std::is_copy_constructible_v<E>
+  constexpr expected(expected const& rhs) requires detail::copy_constructible<E>
       : has_val(rhs.has_value()) {
-    if (!rhs.has_value()) {
+    if (rhs.has_value()) {
+      set_has_value(true);
+    } else {
       std::construct_at(std::addressof(this->unex), rhs.error());
     }
   }
 
   constexpr expected(expected&&) 
     noexcept(std::is_nothrow_move_constructible_v<E>)
-    requires std::is_move_constructible_v<E> &&
+    requires detail::move_constructible<E> &&
              std::is_trivially_move_constructible_v<E>
   = default;
 
   constexpr expected(expected&& rhs) noexcept(std::is_nothrow_move_constructible_v<E>)
-    requires std::is_move_constructible_v<E> : has_val(rhs.has_value()) {
-    if (!rhs.has_value()) {
+    requires detail::move_constructible<E> : has_val(rhs.has_value()) {
+    if (rhs.has_value()) {
+      set_has_value(true);
+    } else {
       std::construct_at(std::addressof(this->unex), std::move(rhs.error()));
     }
   }
@@ -984,11 +1883,13 @@ class expected<void, E> {
       &&(!std::is_constructible_v<unexpected<E>, expected<U, G>&>)        
       &&(!std::is_constructible_v<unexpected<E>, expected<U, G>>)         
       &&(!std::is_constructible_v<unexpected<E>, expected<U, G> const&>)  
-      &&(!std::is_constructible_v<unexpected<E>, expected<U, G> const&>)  
+      &&(!std::is_constructible_v<unexpected<E>, expected<U, G> const>)   
       constexpr explicit(!std::is_convertible_v<G const&, E>)
           expected(expected<U, G> const& rhs)  // NOLINT
       : has_val(rhs.has_value()) {
-    if (!rhs.has_value()) {
+    if (rhs.has_value()) {
+      set_has_value(true);
+    } else {
       std::construct_at(std::addressof(this->unex),
                         std::forward<G const&>(rhs.error()));
     }
@@ -1000,11 +1901,13 @@ class expected<void, E> {
       &&(!std::is_constructible_v<unexpected<E>, expected<U, G>&>)        
       &&(!std::is_constructible_v<unexpected<E>, expected<U, G>>)         
       &&(!std::is_constructible_v<unexpected<E>, expected<U, G> const&>)  
-      &&(!std::is_constructible_v<unexpected<E>, expected<U, G> const&>)  
-      constexpr explicit(!std::is_convertible_v<G const&, E>)
+      &&(!std::is_constructible_v<unexpected<E>, expected<U, G> const>)   
+      constexpr explicit(!std::is_convertible_v<G, E>)
           expected(expected<U, G>&& rhs)  // NOLINT
       : has_val(rhs.has_value()) {
-    if (!rhs.has_value()) {
+    if (rhs.has_value()) {
+      set_has_value(true);
+    } else {
       std::construct_at(std::addressof(this->unex),
                         std::forward<G>(rhs.error()));
     }
@@ -1022,7 +1925,9 @@ class expected<void, E> {
       expected(unexpected<G>&& e)  // NOLINT
       : has_val(false), unex(std::forward<G>(e.value())) {}
 
-  constexpr explicit expected(std::in_place_t /*unused*/) noexcept {}
+  constexpr explicit expected(std::in_place_t /*unused*/) noexcept {
+    set_has_value(true);
+  }
 
   template <class... Args>
   requires std::is_constructible_v<E, Args...>
@@ -1036,42 +1941,50 @@ class expected<void, E> {
   unex(il, std::forward<Args>(args)...) {}
 
   // destructor
+  constexpr ~expected() requires std::is_trivially_destructible_v<E>
+  = default;
+
   constexpr ~expected() {
-    if constexpr (std::is_trivially_destructible_v<E>) {
-    } else {
-      if (!has_value()) std::destroy_at(std::addressof(this->unex));
-    }
+    if (!has_value()) std::destroy_at(std::addressof(this->unex));
   }
 
   // assignment
+  constexpr auto operator=(expected const&) -> expected&  // NOLINT
+      requires detail::void_expected_copy_assignable<E> &&
+      detail::trivially_copy_assignable_alternative<E>
+  = default;
+
   constexpr auto operator=(expected const& rhs) -> expected&  // NOLINT
-      requires std::is_copy_assignable_v<E> &&
-               std::is_copy_constructible_v<E> {
+      requires detail::void_expected_copy_assignable<E> {
     if (has_value() && rhs.has_value()) {
     } else if (has_value()) {
       std::construct_at(std::addressof(this->unex), rhs.unex);
-      has_val = false;
+      set_has_value(false);
     } else if (rhs.has_value()) {
       std::destroy_at(std::addressof(this->unex));
-      has_val = true;
+      set_has_value(true);
     } else {
       this->unex = rhs.error();
     }
     return *this;
   }
 
+  constexpr auto operator=(expected&&) noexcept -> expected&  // NOLINT
+    requires detail::void_expected_move_assignable<E> &&
+             detail::trivially_move_assignable_alternative<E>
+  = default;
+
   constexpr auto operator=(expected&& rhs) 
     noexcept(std::is_nothrow_move_constructible_v<E>&&
              std::is_nothrow_move_assignable_v<E>) -> expected& 
-    requires std::is_move_constructible_v<E> &&
-             std::is_move_assignable_v<E> {
+    requires detail::void_expected_move_assignable<E> {
     if (has_value() && rhs.has_value()) {
     } else if (has_value()) {
       std::construct_at(std::addressof(this->unex), std::move(rhs.unex));
-      has_val = false;
+      set_has_value(false);
     } else if (rhs.has_value()) {
       std::destroy_at(std::addressof(this->unex));
-      has_val = true;
+      set_has_value(true);
     } else {
       this->unex = std::move(rhs.error());
     }
@@ -1085,7 +1998,7 @@ class expected<void, E> {
     if (has_value()) {
       std::construct_at(std::addressof(this->unex),
                         std::forward<G const&>(e.value()));
-      has_val = false;
+      set_has_value(false);
     } else {
       this->unex = std::forward<G const&>(e.value());
     }
@@ -1098,7 +2011,7 @@ class expected<void, E> {
   constexpr auto operator=(unexpected<G>&& e) -> expected& {
     if (has_value()) {
       std::construct_at(std::addressof(this->unex), std::forward<G>(e.value()));
-      has_val = false;
+      set_has_value(false);
     } else {
       this->unex = std::forward<G>(e.value());
     }
@@ -1109,7 +2022,7 @@ class expected<void, E> {
   constexpr void emplace() noexcept {
     if (!has_value()) {
       std::destroy_at(std::addressof(this->unex));
-      has_val = true;
+      set_has_value(true);
     }
   }
 
@@ -1127,10 +2040,9 @@ class expected<void, E> {
       }
     } else {
       if (has_value()) {
-        std::construct_at(std::addressof(this->unex), std::move(rhs.unex));
-        std::destroy_at(std::addressof(rhs.unex));
-        has_val = false;
-        rhs.has_val = true;
+        relocate_at(std::addressof(rhs.unex), std::addressof(this->unex));
+        set_has_value(false);
+        rhs.set_has_value(true);
       } else {
         using std::swap;
         swap(this->unex, rhs.unex);
@@ -1139,38 +2051,64 @@ class expected<void, E> {
   }
 
   // observers
-  constexpr explicit operator bool() const noexcept { return has_val; }
+  constexpr explicit operator bool() const noexcept { return has_value(); }
 
   [[nodiscard]] constexpr auto has_value() const noexcept -> bool {
-    return has_val;
+    if constexpr (error_niche::enabled) {
+      if (std::is_constant_evaluated()) {
+        return detail::constant_evaluated_alive(this->val);
+      }
+      return error_niche::holds_tag(std::addressof(this->val));
+    } else {
+      return has_val;
+    }
   }
 
   // precondition: has_value() = true
-  constexpr void operator*() const noexcept {}
+  constexpr void operator*() const noexcept {
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator* on an expected without a value");
+  }
 
   constexpr void value() const& {
-    if (!has_value()) {
-      throw bad_expected_access(error());
+    if (!has_value()) [[unlikely]] {
+      detail::throw_bad_expected_access(error());
     }
   }
 
   constexpr void value() && {
-    if (!has_value()) {
-      throw bad_expected_access(std::move(error()));
+    if (!has_value()) [[unlikely]] {
+      detail::throw_bad_expected_access(std::move(error()));
     }
   }
 
   // precondition: has_value() = false
-  constexpr auto error() const& -> E const& { return this->unex; }
+  constexpr auto error() const& -> E const& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return this->unex;
+  }
 
   // precondition: has_value() = false
-  constexpr auto error() & -> E& { return this->unex; }
+  constexpr auto error() & -> E& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return this->unex;
+  }
 
   // precondition: has_value() = false
-  constexpr auto error() const&& -> E const&& { return std::move(this->unex); }
+  constexpr auto error() const&& -> E const&& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return std::move(this->unex);
+  }
 
   // precondition: has_value() = false
-  constexpr auto error() && -> E&& { return std::move(this->unex); }
+  constexpr auto error() && -> E&& {
+    RD_EXPECTED_PRECONDITION(!has_value(),
+                             "error() on an expected with a value");
+    return std::move(this->unex);
+  }
 
   // monadic
   template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F>>>
@@ -1179,7 +2117,7 @@ class expected<void, E> {
            std::is_copy_constructible_v<E>
   constexpr auto and_then(F&& f) & {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f));
+      return detail::invoke(std::forward<F>(f));
     }
     return U(unexpect, error());
   }
@@ -1190,7 +2128,7 @@ class expected<void, E> {
            std::is_copy_constructible_v<E>
   constexpr auto and_then(F&& f) const& {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f));
+      return detail::invoke(std::forward<F>(f));
     }
     return U(unexpect, error());
   }
@@ -1201,7 +2139,7 @@ class expected<void, E> {
            std::is_move_constructible_v<E>
   constexpr auto and_then(F&& f) && {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f));
+      return detail::invoke(std::forward<F>(f));
     }
     return U(unexpect, std::move(error()));
   }
@@ -1212,7 +2150,7 @@ class expected<void, E> {
            std::is_move_constructible_v<E>
   constexpr auto and_then(F&& f) const&& {
     if (has_value()) {
-      return std::invoke(std::forward<F>(f));
+      return detail::invoke(std::forward<F>(f));
     }
     return U(unexpect, std::move(error()));
   }
@@ -1226,7 +2164,7 @@ class expected<void, E> {
     if (has_value()) {
       return G{};
     }
-    return std::invoke(std::forward<F>(f), error());
+    return detail::invoke(std::forward<F>(f), error());
   }
 
   template <class F, class V = E const&,
@@ -1238,7 +2176,7 @@ class expected<void, E> {
     if (has_value()) {
       return G{};
     }
-    return std::invoke(std::forward<F>(f), error());
+    return detail::invoke(std::forward<F>(f), error());
   }
 
   template <class F, class V = E&&,
@@ -1250,7 +2188,7 @@ class expected<void, E> {
     if (has_value()) {
       return G{};
     }
-    return std::invoke(std::forward<F>(f), std::move(error()));
+    return detail::invoke(std::forward<F>(f), std::move(error()));
   }
 
   template <class F, class V = E const&&,
@@ -1262,7 +2200,7 @@ class expected<void, E> {
     if (has_value()) {
       return G{};
     }
-    return std::invoke(std::forward<F>(f), std::move(error()));
+    return detail::invoke(std::forward<F>(f), std::move(error()));
   }
 
   template <class F, class V = E&,
@@ -1273,7 +2211,7 @@ class expected<void, E> {
     if (has_value()) {
       return expected(*this);
     }
-    std::invoke(std::forward<F>(f), error());
+    detail::invoke(std::forward<F>(f), error());
     return expected(*this);
   }
 
@@ -1285,36 +2223,30 @@ class expected<void, E> {
     if (has_value()) {
       return expected(*this);
     }
-    std::invoke(std::forward<F>(f), error());
+    detail::invoke(std::forward<F>(f), error());
     return expected(*this);
   }
 
-  template <class F, class V = E&&,
+  template <class F, class V = E&,
             class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
   requires std::is_void_v<G> &&
-           std::is_move_constructible_v<E> &&
-           std::is_copy_constructible_v<E>
+           std::is_move_constructible_v<E>
   constexpr auto or_else(F&& f) && {
-    if (has_value()) {
-      return expected(std::move(*this));
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
     }
-    // TODO: is this copy necessary, as f can be just read argument function
-    std::invoke(std::forward<F>(f), error());
     return expected(std::move(*this));
   }
 
-  template <class F, class V = E const&&,
+  template <class F, class V = E const&,
             class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
   requires std::is_void_v<G> &&
-           std::is_move_constructible_v<E> &&
            std::is_copy_constructible_v<E>
   constexpr auto or_else(F&& f) const&& {
     if (!has_value()) {
-      return expected(std::move(*this));
+      detail::invoke(std::forward<F>(f), error());
     }
-    // TODO: is this copy necessary, as f can be just read argument function
-    std::invoke(std::forward<F>(f), error());
-    return expected(std::move(*this));
+    return expected(*this);
   }
 
   template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F>>>
@@ -1322,9 +2254,9 @@ class expected<void, E> {
   constexpr auto transform(F&& f) & {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
-        return expected<U, E>(std::invoke(std::forward<F>(f)));
+        return expected<U, E>(detail::invoke(std::forward<F>(f)));
       } else {
-        std::invoke(std::forward<F>(f));
+        detail::invoke(std::forward<F>(f));
         return expected<U, E>();
       }
     }
@@ -1336,9 +2268,9 @@ class expected<void, E> {
   constexpr auto transform(F&& f) const& {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
-        return expected<U, E>(std::invoke(std::forward<F>(f)));
+        return expected<U, E>(detail::invoke(std::forward<F>(f)));
       } else {
-        std::invoke(std::forward<F>(f));
+        detail::invoke(std::forward<F>(f));
         return expected<U, E>();
       }
     }
@@ -1350,9 +2282,9 @@ class expected<void, E> {
   constexpr auto transform(F&& f) && {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
-        return expected<U, E>(std::invoke(std::forward<F>(f)));
+        return expected<U, E>(detail::invoke(std::forward<F>(f)));
       } else {
-        std::invoke(std::forward<F>(f));
+        detail::invoke(std::forward<F>(f));
         return expected<U, E>();
       }
     }
@@ -1364,9 +2296,9 @@ class expected<void, E> {
   constexpr auto transform(F&& f) const&& {
     if (has_value()) {
       if constexpr (!std::same_as<U, void>) {
-        return expected<U, E>(std::invoke(std::forward<F>(f)));
+        return expected<U, E>(detail::invoke(std::forward<F>(f)));
       } else {
-        std::invoke(std::forward<F>(f));
+        detail::invoke(std::forward<F>(f));
         return expected<U, E>();
       }
     }
@@ -1381,7 +2313,7 @@ class expected<void, E> {
       return expected<void, G>{};
     }
     return expected<void, G>(unexpect,
-                             std::invoke(std::forward<F>(f), error()));
+                             detail::invoke(std::forward<F>(f), error()));
   }
 
   template <class F, class V = E const&,
@@ -1392,7 +2324,7 @@ class expected<void, E> {
       return expected<void, G>{};
     }
     return expected<void, G>(unexpect,
-                             std::invoke(std::forward<F>(f), error()));
+                             detail::invoke(std::forward<F>(f), error()));
   }
 
   template <class F, class V = E&&,
@@ -1403,7 +2335,7 @@ class expected<void, E> {
       return expected<void, G>{};
     }
     return expected<void, G>(
-        unexpect, std::invoke(std::forward<F>(f), std::move(error())));
+        unexpect, detail::invoke(std::forward<F>(f), std::move(error())));
   }
 
   template <class F, class V = E const&&,
@@ -1414,7 +2346,164 @@ class expected<void, E> {
       return expected<void, G>{};
     }
     return expected<void, G>(
-        unexpect, std::invoke(std::forward<F>(f), std::move(error())));
+        unexpect, detail::invoke(std::forward<F>(f), std::move(error())));
+  }
+
+  // inspect, inspect_error: see the primary template; f() takes no
+  // arguments for the value.
+  template <class F>
+  requires std::is_invocable_v<F>
+  constexpr auto inspect(F&& f) & -> expected& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F>
+  constexpr auto inspect(F&& f) const& -> expected const& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F>
+  constexpr auto inspect(F&& f) && -> expected&& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f));
+    }
+    return std::move(*this);
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F>
+  constexpr auto inspect(F&& f) const&& -> expected const&& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f));
+    }
+    return std::move(*this);
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) & -> expected& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) const& -> expected const& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) && -> expected&& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return std::move(*this);
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) const&& -> expected const&& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return std::move(*this);
+  }
+
+  // Mutating counterparts of transform_error and and_then, see the primary
+  // template.
+  // transform_error_inplace: f(error&) updates the error where it is.
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, E&>>
+  constexpr auto transform_error_inplace(F&& f) & -> expected& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, E&>>
+  constexpr auto transform_error_inplace(F&& f) && -> expected&& {
+    return std::move(transform_error_inplace(std::forward<F>(f)));
+  }
+
+  // and_then_inplace: f() returns an expected<void, E>, whose error is taken.
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F>>>
+  requires detail::is_expected<U> && std::is_void_v<typename U::value_type> &&
+      std::is_same_v<typename U::error_type, E> &&
+      std::is_move_constructible_v<E>
+  constexpr auto and_then_inplace(F&& f) & -> expected& {
+    if (has_value()) {
+      auto r = detail::invoke(std::forward<F>(f));
+      if (!r.has_value()) {
+        std::construct_at(std::addressof(this->unex), std::move(r).error());
+        set_has_value(false);
+      }
+    }
+    return *this;
+  }
+
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F>>>
+  requires detail::is_expected<U> && std::is_void_v<typename U::value_type> &&
+      std::is_same_v<typename U::error_type, E> &&
+      std::is_move_constructible_v<E>
+  constexpr auto and_then_inplace(F&& f) && -> expected&& {
+    return std::move(and_then_inplace(std::forward<F>(f)));
+  }
+
+  // context: records c on the error, if any. Frames are a pointer to static
+  // text, so this is cheap for errors that keep them inline (see
+  // rd::error_chain).
+  template <class G = E>
+  requires detail::context_error<G>
+  constexpr auto context(static_context c) & -> expected& {
+    if (!has_value()) {
+      error().add_context(c);
+    }
+    return *this;
+  }
+
+  template <class G = E>
+  requires detail::context_error<G>
+  constexpr auto context(static_context c) && -> expected {
+    if (!has_value()) {
+      error().add_context(c);
+    }
+    return std::move(*this);
+  }
+
+  // with_context: like context, but f builds the frame and is only invoked
+  // on error.
+  template <class F>
+  requires detail::lazy_context_error<E, F>
+  constexpr auto with_context(F&& f) & -> expected& {
+    if (!has_value()) {
+      error().add_context(detail::invoke(std::forward<F>(f)));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires detail::lazy_context_error<E, F>
+  constexpr auto with_context(F&& f) && -> expected {
+    if (!has_value()) {
+      error().add_context(detail::invoke(std::forward<F>(f)));
+    }
+    return std::move(*this);
   }
 
   // expected equality operators
@@ -1444,10 +2533,557 @@ class expected<void, E> {
   }
 
  private:
-  bool has_val{true};
+  using error_niche = detail::error_niche_layout<0, E>;
+
+  // Starting the lifetime of the empty value slot also keeps a constexpr
+  // expected<void, E> fully initialized.
+  constexpr void set_has_value(bool v) noexcept {
+    has_val = v;
+    if (v) {
+      std::construct_at(std::addressof(this->val), std::in_place);
+    }
+  }
+
+  // When E has a niche, the state lives in the storage and this member takes
+  // no space.
+  [[no_unique_address]] std::conditional_t<error_niche::enabled,
+                                           detail::niche_flag, bool>
+      has_val{true};
   union {
     E unex;
+    detail::value_slot<void, E> val;
   };
 };
 
+// expected<T&, E> refers to a T that lives elsewhere. It stores a pointer, so
+// with a niche in T* it is no larger than expected<T*, E>. Like a pointer it
+// has shallow constness and assignment rebinds the reference.
+template <class T, std::destructible E>
+class expected<T&, E> {
+ public:
+  using value_type = T&;
+  using error_type = E;
+  using unexpected_type = unexpected<E>;
+
+  template <class U>
+  using rebind = expected<U, error_type>;
+
+  // constructors
+  constexpr expected(expected const&) = default;
+  constexpr expected(expected&&) = default;  // NOLINT
+
+  template <class U, class G>
+  requires std::is_convertible_v<U*, T*> && std::constructible_from<E, G const&>
+  constexpr explicit(!std::convertible_to<G const&, E>)
+      expected(expected<U&, G> const& rhs)  // NOLINT
+      : ptr(rhs.has_value() ? storage(std::addressof(*rhs))
+                            : storage(unexpect, rhs.error())) {}
+
+  template <class U, class G>
+  requires std::is_convertible_v<U*, T*> && std::constructible_from<E, G>
+  constexpr explicit(!std::convertible_to<G, E>)
+      expected(expected<U&, G>&& rhs)  // NOLINT
+      : ptr(rhs.has_value() ? storage(std::addressof(*rhs))
+                            : storage(unexpect, std::move(rhs).error())) {}
+
+  template <class U>
+  requires std::is_convertible_v<U*, T*>
+  constexpr expected(U& v) noexcept  // NOLINT
+      : ptr(std::addressof(v)) {}
+
+  // binding to a temporary would leave a dangling reference
+  template <class U>
+  requires std::is_convertible_v<U*, T*>
+  expected(U const&& v) = delete;  // NOLINT
+
+  template <class G>
+  requires std::constructible_from<E, G const&>
+  constexpr explicit(!std::convertible_to<G const&, E>)
+      expected(unexpected<G> const& e)  // NOLINT
+      : ptr(e) {}
+
+  template <class G>
+  requires std::constructible_from<E, G>
+  constexpr explicit(!std::convertible_to<G, E>)
+      expected(unexpected<G>&& e)  // NOLINT
+      : ptr(std::move(e)) {}
+
+  template <class U>
+  requires std::is_convertible_v<U*, T*>
+  constexpr explicit expected(std::in_place_t /*unused*/, U& v) noexcept
+      : ptr(std::addressof(v)) {}
+
+  template <class... Args>
+  requires std::constructible_from<E, Args...>
+  constexpr explicit expected(unexpect_t /*unused*/, Args&&... args)
+      : ptr(unexpect, std::forward<Args>(args)...) {}
+
+  template <class U, class... Args>
+  requires std::constructible_from < E, std::initializer_list<U>
+  &, Args... > constexpr explicit expected(unexpect_t /*unused*/,
+                                           std::initializer_list<U> il,
+                                           Args&&... args)
+      : ptr(unexpect, il, std::forward<Args>(args)...) {}
+
+  // assignment rebinds the reference
+  constexpr auto operator=(expected const&) -> expected& = default;
+  constexpr auto operator=(expected&&) -> expected& = default;  // NOLINT
+
+  template <class U>
+  requires std::is_convertible_v<U*, T*>
+  constexpr auto operator=(U& v) -> expected& {
+    ptr = std::addressof(v);
+    return *this;
+  }
+
+  template <class U>
+  requires std::is_convertible_v<U*, T*>
+  auto operator=(U const&& v) -> expected& = delete;
+
+  template <class G>
+  requires std::constructible_from<E, G const&> &&
+      std::is_assignable_v<E&, G const&>
+  constexpr auto operator=(unexpected<G> const& e) -> expected& {
+    ptr = e;
+    return *this;
+  }
+
+  template <class G>
+  requires std::constructible_from<E, G> && std::is_assignable_v<E&, G>
+  constexpr auto operator=(unexpected<G>&& e) -> expected& {
+    ptr = std::move(e);
+    return *this;
+  }
+
+  // modifiers
+  template <class U>
+  requires std::is_convertible_v<U*, T*>
+  constexpr auto emplace(U& v) noexcept -> T& {
+    return *ptr.emplace(std::addressof(v));
+  }
+
+  // swap
+  constexpr void swap(expected& rhs) noexcept(noexcept(ptr.swap(rhs.ptr)))
+    requires std::is_swappable_v<E> && std::is_move_constructible_v<E>
+  {
+    ptr.swap(rhs.ptr);
+  }
+
+  // observers
+
+  // precondition: has_value() = true
+  constexpr auto operator->() const noexcept -> T* {
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator-> on an expected without a value");
+    return *ptr;
+  }
+
+  // precondition: has_value() = true
+  constexpr auto operator*() const noexcept -> T& {
+    RD_EXPECTED_PRECONDITION(has_value(),
+                             "operator* on an expected without a value");
+    return **ptr;
+  }
+
+  constexpr explicit operator bool() const noexcept { return has_value(); }
+
+  [[nodiscard]] constexpr auto has_value() const noexcept -> bool {
+    return ptr.has_value();
+  }
+
+  constexpr auto value() const& -> T& {
+    if (has_value()) [[likely]] {
+      return **ptr;
+    }
+    detail::throw_bad_expected_access(error());
+  }
+
+  constexpr auto value() && -> T& {
+    if (has_value()) [[likely]] {
+      return **ptr;
+    }
+    detail::throw_bad_expected_access(std::move(error()));
+  }
+
+  // precondition: has_value() = false
+  constexpr auto error() const& -> E const& { return ptr.error(); }
+
+  // precondition: has_value() = false
+  constexpr auto error() & -> E& { return ptr.error(); }
+
+  // precondition: has_value() = false
+  constexpr auto error() const&& -> E const&& {
+    return std::move(ptr).error();
+  }
+
+  // precondition: has_value() = false
+  constexpr auto error() && -> E&& { return std::move(ptr).error(); }
+
+  template <class U>
+  requires std::is_copy_constructible_v<std::remove_cv_t<T>> &&
+      std::is_convertible_v<U, std::remove_cv_t<T>>
+  constexpr auto value_or(U&& v) const -> std::remove_cv_t<T> {
+    return has_value() ? **this
+                       : static_cast<std::remove_cv_t<T>>(std::forward<U>(v));
+  }
+
+  // monadic, the referred object is passed as T& whatever the value category
+  // of expected is
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F, T&>>>
+  requires detail::is_expected<U> &&
+      std::is_same_v<typename U::error_type, E> &&
+      std::is_copy_constructible_v<E>
+  constexpr auto and_then(F&& f) const& {
+    if (has_value()) {
+      return detail::invoke(std::forward<F>(f), **this);
+    }
+    return U(unexpect, error());
+  }
+
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F, T&>>>
+  requires detail::is_expected<U> &&
+      std::is_same_v<typename U::error_type, E> &&
+      std::is_move_constructible_v<E>
+  constexpr auto and_then(F&& f) && {
+    if (has_value()) {
+      return detail::invoke(std::forward<F>(f), **this);
+    }
+    return U(unexpect, std::move(error()));
+  }
+
+  template <class F, class V = E&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires detail::is_expected<G> &&
+      std::is_same_v<typename G::value_type, T&> &&
+      std::is_copy_constructible_v<E>
+  constexpr auto or_else(F&& f) & {
+    if (has_value()) {
+      return G(**this);
+    }
+    return detail::invoke(std::forward<F>(f), error());
+  }
+
+  template <class F, class V = E const&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires detail::is_expected<G> &&
+      std::is_same_v<typename G::value_type, T&> &&
+      std::is_copy_constructible_v<E>
+  constexpr auto or_else(F&& f) const& {
+    if (has_value()) {
+      return G(**this);
+    }
+    return detail::invoke(std::forward<F>(f), error());
+  }
+
+  template <class F, class V = E&&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires detail::is_expected<G> &&
+      std::is_same_v<typename G::value_type, T&> &&
+      std::is_move_constructible_v<E>
+  constexpr auto or_else(F&& f) && {
+    if (has_value()) {
+      return G(**this);
+    }
+    return detail::invoke(std::forward<F>(f), std::move(error()));
+  }
+
+  template <class F, class V = E const&&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires detail::is_expected<G> &&
+      std::is_same_v<typename G::value_type, T&> &&
+      std::is_move_constructible_v<E>
+  constexpr auto or_else(F&& f) const&& {
+    if (has_value()) {
+      return G(**this);
+    }
+    return detail::invoke(std::forward<F>(f), std::move(error()));
+  }
+
+  template <class F, class V = E&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_void_v<G> && std::is_copy_constructible_v<E>
+  constexpr auto or_else(F&& f) & {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
+    }
+    return expected(*this);
+  }
+
+  template <class F, class V = E const&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_void_v<G> && std::is_copy_constructible_v<E>
+  constexpr auto or_else(F&& f) const& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
+    }
+    return expected(*this);
+  }
+
+  template <class F, class V = E&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_void_v<G> && std::is_move_constructible_v<E>
+  constexpr auto or_else(F&& f) && {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
+    }
+    return expected(std::move(*this));
+  }
+
+  template <class F, class V = E const&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_void_v<G> && std::is_copy_constructible_v<E>
+  constexpr auto or_else(F&& f) const&& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
+    }
+    return expected(*this);
+  }
+
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F, T&>>>
+  requires std::is_copy_constructible_v<E>
+  constexpr auto transform(F&& f) const& {
+    if (has_value()) {
+      if constexpr (!std::same_as<U, void>) {
+        return expected<U, E>(detail::invoke(std::forward<F>(f), **this));
+      } else {
+        detail::invoke(std::forward<F>(f), **this);
+        return expected<U, E>();
+      }
+    }
+    return expected<U, E>(unexpect, error());
+  }
+
+  template <class F, class U = std::remove_cvref_t<std::invoke_result_t<F, T&>>>
+  requires std::is_move_constructible_v<E>
+  constexpr auto transform(F&& f) && {
+    if (has_value()) {
+      if constexpr (!std::same_as<U, void>) {
+        return expected<U, E>(detail::invoke(std::forward<F>(f), **this));
+      } else {
+        detail::invoke(std::forward<F>(f), **this);
+        return expected<U, E>();
+      }
+    }
+    return expected<U, E>(unexpect, std::move(error()));
+  }
+
+  template <class F, class V = E&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_copy_constructible_v<E>
+  constexpr auto transform_error(F&& f) & {
+    if (has_value()) {
+      return expected<T&, G>(**this);
+    }
+    return expected<T&, G>(unexpect, detail::invoke(std::forward<F>(f), error()));
+  }
+
+  template <class F, class V = E const&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_copy_constructible_v<E>
+  constexpr auto transform_error(F&& f) const& {
+    if (has_value()) {
+      return expected<T&, G>(**this);
+    }
+    return expected<T&, G>(unexpect, detail::invoke(std::forward<F>(f), error()));
+  }
+
+  template <class F, class V = E&&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_move_constructible_v<E>
+  constexpr auto transform_error(F&& f) && {
+    if (has_value()) {
+      return expected<T&, G>(**this);
+    }
+    return expected<T&, G>(unexpect,
+                           detail::invoke(std::forward<F>(f), std::move(error())));
+  }
+
+  template <class F, class V = E const&&,
+            class G = std::remove_cvref_t<std::invoke_result_t<F, V>>>
+  requires std::is_move_constructible_v<E>
+  constexpr auto transform_error(F&& f) const&& {
+    if (has_value()) {
+      return expected<T&, G>(**this);
+    }
+    return expected<T&, G>(unexpect,
+                           detail::invoke(std::forward<F>(f), std::move(error())));
+  }
+
+  // inspect, inspect_error: see the primary template.
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) & -> expected& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) const& -> expected const& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) && -> expected&& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
+    }
+    return std::move(*this);
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, T const&>
+  constexpr auto inspect(F&& f) const&& -> expected const&& {
+    if (has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(**this));
+    }
+    return std::move(*this);
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) & -> expected& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) const& -> expected const& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) && -> expected&& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return std::move(*this);
+  }
+
+  template <class F>
+  requires std::is_invocable_v<F, E const&>
+  constexpr auto inspect_error(F&& f) const&& -> expected const&& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), std::as_const(error()));
+    }
+    return std::move(*this);
+  }
+
+  // Mutating counterpart of transform_error, see the primary template.
+  // transform_error_inplace: f(error&) updates the error where it is.
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, E&>>
+  constexpr auto transform_error_inplace(F&& f) & -> expected& {
+    if (!has_value()) {
+      detail::invoke(std::forward<F>(f), error());
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires std::is_void_v<std::invoke_result_t<F, E&>>
+  constexpr auto transform_error_inplace(F&& f) && -> expected&& {
+    return std::move(transform_error_inplace(std::forward<F>(f)));
+  }
+
+  // context: records c on the error, if any. Frames are a pointer to static
+  // text, so this is cheap for errors that keep them inline (see
+  // rd::error_chain).
+  template <class G = E>
+  requires detail::context_error<G>
+  constexpr auto context(static_context c) & -> expected& {
+    if (!has_value()) {
+      error().add_context(c);
+    }
+    return *this;
+  }
+
+  template <class G = E>
+  requires detail::context_error<G>
+  constexpr auto context(static_context c) && -> expected {
+    if (!has_value()) {
+      error().add_context(c);
+    }
+    return std::move(*this);
+  }
+
+  // with_context: like context, but f builds the frame and is only invoked
+  // on error.
+  template <class F>
+  requires detail::lazy_context_error<E, F>
+  constexpr auto with_context(F&& f) & -> expected& {
+    if (!has_value()) {
+      error().add_context(detail::invoke(std::forward<F>(f)));
+    }
+    return *this;
+  }
+
+  template <class F>
+  requires detail::lazy_context_error<E, F>
+  constexpr auto with_context(F&& f) && -> expected {
+    if (!has_value()) {
+      error().add_context(detail::invoke(std::forward<F>(f)));
+    }
+    return std::move(*this);
+  }
+
+  // equality operators
+  template <class T2, class E2>
+  requires(!std::is_void_v<T2>) &&
+      requires(T const& t1, T2 const& t2, E const& e1, E2 const& e2) {
+    { t1 == t2 } -> std::convertible_to<bool>;
+    { e1 == e2 } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(expected const& x, expected<T2, E2> const& y)
+      -> bool {
+    if (x.has_value() != y.has_value()) {
+      return false;
+    }
+    return x.has_value() ? (*x == *y) : (x.error() == y.error());
+  }
+
+  template <class Self, class T2>
+  requires std::same_as<Self, expected> && (!detail::is_expected<T2>) &&
+      requires(T const& x, T2 const& v) {
+    { x == v } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(Self const& x, T2 const& v) -> bool {
+    return x.has_value() && static_cast<bool>(*x == v);
+  }
+
+  template <class E2>
+  requires requires(E const& x, unexpected<E2> const& e) {
+    { x == e.value() } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(expected const& x, unexpected<E2> const& e)
+      -> bool {
+    return !x.has_value() && static_cast<bool>(x.error() == e.value());
+  }
+
+  // specialized algorithms
+  friend constexpr void swap(expected& x,
+                             expected& y) noexcept(noexcept(x.swap(y))) {
+    x.swap(y);
+  }
+
+ private:
+  using storage = expected<T*, E>;
+
+  storage ptr;
+};
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
 }  // namespace rd
@@ -0,0 +1,328 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expected.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+// Lazy monadic pipelines:
+//
+//   rd::expected<std::string, error> r =
+//       e | rd::then(parse) | rd::map(twice) | rd::map_error(describe);
+//
+// then, map and map_error are and_then, transform and transform_error as
+// pipeline stages. Stages joined with | compose into one function object and
+// nothing runs until an expected goes through it. The value or error is then
+// handed from stage to stage without an expected in between: a then stage
+// tests the expected its function returns once, map and map_error stages
+// don't branch, and the result is constructed once, in place.
+//
+// e | stages refers to e and runs when converted to its result or with
+// run(), so it has to be used within the full expression.
+template <class... Stages>
+class pipeline;
+
+namespace detail {
+template <class F>
+struct then_stage {
+  F f;
+};
+
+template <class F>
+struct map_stage {
+  F f;
+};
+
+template <class F>
+struct map_error_stage {
+  F f;
+};
+
+template <class T>
+inline constexpr bool is_then_stage = false;
+
+template <class F>
+inline constexpr bool is_then_stage<then_stage<F>> = true;
+
+template <class T>
+inline constexpr bool is_map_stage = false;
+
+template <class F>
+inline constexpr bool is_map_stage<map_stage<F>> = true;
+
+template <class T>
+inline constexpr bool is_map_error_stage = false;
+
+template <class F>
+inline constexpr bool is_map_error_stage<map_error_stage<F>> = true;
+
+// Stands in for the value of an expected<void, E>.
+struct void_value {};
+
+template <class T>
+using value_or_void_value =
+    std::conditional_t<std::is_void_v<T>, void_value, T>;
+
+template <class F, class V>
+constexpr auto call_with_value(F const& f, V&& v) -> decltype(auto) {
+  if constexpr (std::is_same_v<std::remove_cvref_t<V>, void_value>) {
+    return detail::invoke(f);
+  } else {
+    return detail::invoke(f, std::forward<V>(v));
+  }
+}
+
+template <class F, class V>
+using call_with_value_t =
+    decltype(call_with_value(std::declval<F const&>(), std::declval<V>()));
+
+// The expected made by the stages from a value of type X, passed on as V,
+// and an error passed on as G.
+template <class X, class V, class G, class... Stages>
+struct pipeline_result {
+  using type = expected<std::conditional_t<std::is_same_v<X, void_value>,
+                                           void, X>,
+                        std::remove_cvref_t<G>>;
+};
+
+template <class X, class V, class G, class F, class... Stages>
+struct pipeline_result<X, V, G, then_stage<F>, Stages...> {
+  using returned = std::remove_cvref_t<call_with_value_t<F, V>>;
+  static_assert(is_expected<returned>,
+                "the function of rd::then has to return an rd::expected");
+  static_assert(std::is_same_v<typename returned::error_type,
+                               std::remove_cvref_t<G>>,
+                "the function of rd::then has to return an rd::expected "
+                "with the same error type");
+  using value = value_or_void_value<typename returned::value_type>;
+  using type =
+      typename pipeline_result<value, value&&, typename returned::error_type&&,
+                               Stages...>::type;
+};
+
+template <class X, class V, class G, class F, class... Stages>
+struct pipeline_result<X, V, G, map_stage<F>, Stages...> {
+  using value =
+      value_or_void_value<std::remove_cvref_t<call_with_value_t<F, V>>>;
+  using type = typename pipeline_result<value, value&&, G, Stages...>::type;
+};
+
+template <class X, class V, class G, class F, class... Stages>
+struct pipeline_result<X, V, G, map_error_stage<F>, Stages...> {
+  using error = std::remove_cvref_t<std::invoke_result_t<F const&, G>>;
+  using type = typename pipeline_result<X, V, error&&, Stages...>::type;
+};
+
+template <class Source, class... Stages>
+using pipeline_result_t = typename pipeline_result<
+    value_or_void_value<typename std::remove_cvref_t<Source>::value_type>,
+    std::conditional_t<
+        std::is_void_v<typename std::remove_cvref_t<Source>::value_type>,
+        void_value&&, decltype(*std::declval<Source>())>,
+    decltype(std::declval<Source>().error()), Stages...>::type;
+
+// Only map_error stages apply to an error.
+template <class Result, class G>
+constexpr auto run_on_error(G&& g) -> Result {
+  return Result(unexpect, std::forward<G>(g));
+}
+
+template <class Result, class G, class Stage, class... Stages>
+constexpr auto run_on_error(G&& g, Stage const& stage,
+                            Stages const&... stages) -> Result {
+  if constexpr (is_map_error_stage<Stage>) {
+    return run_on_error<Result>(detail::invoke(stage.f, std::forward<G>(g)),
+                                stages...);
+  } else {
+    return run_on_error<Result>(std::forward<G>(g), stages...);
+  }
+}
+
+template <class Result, class V>
+constexpr auto run_on_value(V&& v) -> Result {
+  if constexpr (std::is_same_v<std::remove_cvref_t<V>, void_value>) {
+    return Result();
+  } else {
+    return Result(std::in_place, std::forward<V>(v));
+  }
+}
+
+template <class Result, class V, class Stage, class... Stages>
+constexpr auto run_on_value(V&& v, Stage const& stage,
+                            Stages const&... stages) -> Result {
+  if constexpr (is_then_stage<Stage>) {
+    auto next = call_with_value(stage.f, std::forward<V>(v));
+    if (!next.has_value()) [[unlikely]] {
+      return run_on_error<Result>(std::move(next).error(), stages...);
+    }
+    if constexpr (std::is_void_v<typename decltype(next)::value_type>) {
+      return run_on_value<Result>(void_value{}, stages...);
+    } else {
+      return run_on_value<Result>(*std::move(next), stages...);
+    }
+  } else if constexpr (is_map_stage<Stage>) {
+    if constexpr (std::is_void_v<call_with_value_t<decltype(stage.f), V>>) {
+      call_with_value(stage.f, std::forward<V>(v));
+      return run_on_value<Result>(void_value{}, stages...);
+    } else {
+      return run_on_value<Result>(call_with_value(stage.f, std::forward<V>(v)),
+                                  stages...);
+    }
+  } else {
+    return run_on_value<Result>(std::forward<V>(v), stages...);
+  }
+}
+
+template <class Result, class Source, class... Stages>
+constexpr auto run_pipeline(Source&& source, Stages const&... stages)
+    -> Result {
+  if (source.has_value()) [[likely]] {
+    if constexpr (std::is_void_v<
+                      typename std::remove_cvref_t<Source>::value_type>) {
+      return run_on_value<Result>(void_value{}, stages...);
+    } else {
+      return run_on_value<Result>(*std::forward<Source>(source), stages...);
+    }
+  }
+  return run_on_error<Result>(std::forward<Source>(source).error(),
+                              stages...);
+}
+}  // namespace detail
+
+// Stages composed with |. Calling it with an expected runs the stages on it.
+template <class... Stages>
+class pipeline {
+ public:
+  constexpr explicit pipeline(std::tuple<Stages...> s) : stages(std::move(s)) {}
+
+  template <class Source>
+  requires detail::is_expected<std::remove_cvref_t<Source>>
+  constexpr auto operator()(Source&& source) const
+      -> detail::pipeline_result_t<Source, Stages...> {
+    return run(std::forward<Source>(source),
+               std::index_sequence_for<Stages...>{});
+  }
+
+  template <class... More>
+  friend constexpr auto operator|(pipeline p, pipeline<More...> more)
+      -> pipeline<Stages..., More...> {
+    return pipeline<Stages..., More...>(
+        std::tuple_cat(std::move(p.stages), std::move(more).release()));
+  }
+
+  // The stages, for joining pipelines.
+  constexpr auto release() && -> std::tuple<Stages...> {
+    return std::move(stages);
+  }
+
+ private:
+  template <class Source, std::size_t... I>
+  constexpr auto run(Source&& source, std::index_sequence<I...> /*unused*/)
+      const -> detail::pipeline_result_t<Source, Stages...> {
+    return detail::run_pipeline<detail::pipeline_result_t<Source, Stages...>>(
+        std::forward<Source>(source), std::get<I>(stages)...);
+  }
+
+  std::tuple<Stages...> stages;
+};
+
+// An expected on its way through a pipeline; runs it when converted to the
+// result or on run(). Keeps a reference to an lvalue source and takes an
+// rvalue one by value, so that a pending kept in a variable doesn't outlive a
+// temporary it was made from.
+template <class Source, class... Stages>
+class pending {
+ public:
+  using result_type = detail::pipeline_result_t<Source, Stages...>;
+
+  constexpr pending(Source&& s, pipeline<Stages...> p)
+      : source(std::forward<Source>(s)), stages(std::move(p)) {}
+  pending(pending const&) = delete;
+  pending(pending&&) = delete;
+  auto operator=(pending const&) -> pending& = delete;
+  auto operator=(pending&&) -> pending& = delete;
+  ~pending() = default;
+
+  constexpr auto run() && -> result_type {
+    return stages(std::forward<Source>(source));
+  }
+
+  constexpr operator result_type() && {  // NOLINT
+    return stages(std::forward<Source>(source));
+  }
+
+  template <class... More>
+  friend constexpr auto operator|(pending&& p, pipeline<More...> more)
+      -> pending<Source, Stages..., More...> {
+    return pending<Source, Stages..., More...>(
+        std::forward<Source>(p.source), std::move(p.stages) | std::move(more));
+  }
+
+ private:
+  std::conditional_t<std::is_lvalue_reference_v<Source>, Source,
+                     std::remove_cvref_t<Source>>
+      source;
+  pipeline<Stages...> stages;
+};
+
+template <class Source, class... Stages>
+requires detail::is_expected<std::remove_cvref_t<Source>>
+constexpr auto operator|(Source&& source, pipeline<Stages...> p)
+    -> pending<Source, Stages...> {
+  return pending<Source, Stages...>(std::forward<Source>(source),
+                                    std::move(p));
+}
+
+// f(value) returns an expected with the same error type, like and_then.
+template <class F>
+constexpr auto then(F&& f) -> pipeline<detail::then_stage<std::decay_t<F>>> {
+  return pipeline<detail::then_stage<std::decay_t<F>>>(
+      std::tuple(detail::then_stage<std::decay_t<F>>{std::forward<F>(f)}));
+}
+
+// f(value) is the new value, like transform.
+template <class F>
+constexpr auto map(F&& f) -> pipeline<detail::map_stage<std::decay_t<F>>> {
+  return pipeline<detail::map_stage<std::decay_t<F>>>(
+      std::tuple(detail::map_stage<std::decay_t<F>>{std::forward<F>(f)}));
+}
+
+// f(error) is the new error, like transform_error.
+template <class F>
+constexpr auto map_error(F&& f)
+    -> pipeline<detail::map_error_stage<std::decay_t<F>>> {
+  return pipeline<detail::map_error_stage<std::decay_t<F>>>(std::tuple(
+      detail::map_error_stage<std::decay_t<F>>{std::forward<F>(f)}));
+}
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
@@ -0,0 +1,288 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "error_arena.hpp"
+#include "error_message.hpp"
+#include "expected.hpp"
+
+#include "config.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+template <class E, bool Atomic>
+class basic_shared_error;
+
+namespace detail {
+template <class T>
+inline constexpr bool is_shared_error = false;
+
+template <class E, bool Atomic>
+inline constexpr bool is_shared_error<basic_shared_error<E, Atomic>> = true;
+
+template <bool Atomic>
+class shared_error_count {
+ public:
+  void increment() noexcept { count.fetch_add(1, std::memory_order_relaxed); }
+
+  // Whether that was the last reference.
+  auto decrement() noexcept -> bool {
+    return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+
+  [[nodiscard]] auto get() const noexcept -> std::size_t {
+    return count.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::size_t> count{1};
+};
+
+template <>
+class shared_error_count<false> {
+ public:
+  void increment() noexcept { ++count; }
+
+  auto decrement() noexcept -> bool { return --count == 0; }
+
+  [[nodiscard]] auto get() const noexcept -> std::size_t { return count; }
+
+ private:
+  std::size_t count = 1;
+};
+
+// The count and the E share one allocation from the current error arena,
+// which is remembered for freeing it. Allocator-aware Es get an allocator for
+// that resource too.
+template <class E, bool Atomic>
+struct shared_error_block {
+  using resource_ptr = std::pmr::memory_resource*;
+
+  template <class... Args>
+  explicit shared_error_block(resource_ptr r, Args&&... args)
+      : resource(r),
+        error(std::make_obj_using_allocator<E>(
+            std::pmr::polymorphic_allocator<>(r),
+            std::forward<Args>(args)...)) {}
+
+  template <class... Args>
+  static auto create(Args&&... args) -> shared_error_block* {
+    resource_ptr resource = error_arena::current();
+    void* p = resource->allocate(size, align);
+    if constexpr (exceptions_enabled) {
+      RD_EXPECTED_TRY {
+        return ::new (p)
+            shared_error_block(resource, std::forward<Args>(args)...);
+      } RD_EXPECTED_CATCH_ALL {
+        resource->deallocate(p, size, align);
+        RD_EXPECTED_RETHROW;
+      }
+    } else {
+      return ::new (p)
+          shared_error_block(resource, std::forward<Args>(args)...);
+    }
+  }
+
+  static void release(shared_error_block* b) noexcept {
+    if (b->count.decrement()) {
+      resource_ptr resource = b->resource;
+      std::destroy_at(b);
+      resource->deallocate(b, size, align);
+    }
+  }
+
+  static constexpr std::size_t size = sizeof(shared_error_block);
+  static constexpr std::size_t align = alignof(shared_error_block);
+
+  resource_ptr resource;
+  shared_error_count<Atomic> count;
+  E const error;
+};
+}  // namespace detail
+
+// An immutable E shared by all copies of it, with the reference count in the
+// same allocation. Used as the error type of expected, passing an error on
+// from an lvalue (and_then &, transform & etc.) and fanning a failure out to
+// many consumers copies a pointer and bumps the count instead of copying the
+// E. Moving leaves the source valueless.
+//
+// The count is atomic unless Atomic is false, which is cheaper but only right
+// while all copies stay on one thread. The E is allocated from
+// rd::error_arena::current(), i.e. from the default memory resource outside
+// of any error arena.
+template <class E, bool Atomic = true>
+class basic_shared_error {
+ public:
+  using value_type = E;
+
+  template <class... Args>
+  requires std::constructible_from<E, Args...>
+  explicit basic_shared_error(std::in_place_t /*unused*/, Args&&... args)
+      : ptr(block::create(std::forward<Args>(args)...)) {}
+
+  template <class G = E>
+  requires(!detail::is_shared_error<std::remove_cvref_t<G>>) &&
+      (!std::same_as<std::remove_cvref_t<G>, std::in_place_t>) &&
+      std::constructible_from<E, G>
+  explicit(!std::convertible_to<G, E>) basic_shared_error(G&& e)  // NOLINT
+      : ptr(block::create(std::forward<G>(e))) {}
+
+  basic_shared_error(basic_shared_error const& rhs) noexcept : ptr(rhs.ptr) {
+    if (ptr != nullptr) {
+      ptr->count.increment();
+    }
+  }
+
+  // postcondition: rhs.valueless_after_move() = true
+  constexpr basic_shared_error(basic_shared_error&& rhs) noexcept
+      : ptr(std::exchange(rhs.ptr, nullptr)) {}
+
+  auto operator=(basic_shared_error const& rhs) noexcept
+      -> basic_shared_error& {
+    basic_shared_error(rhs).swap(*this);
+    return *this;
+  }
+
+  // postcondition: rhs.valueless_after_move() = true, unless rhs is *this
+  auto operator=(basic_shared_error&& rhs) noexcept -> basic_shared_error& {
+    if (this != &rhs) {
+      basic_shared_error(std::move(rhs)).swap(*this);
+    }
+    return *this;
+  }
+
+  ~basic_shared_error() {
+    if (ptr != nullptr) {
+      block::release(ptr);
+    }
+  }
+
+  // observers
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator*() const noexcept -> E const& {
+    RD_EXPECTED_PRECONDITION(ptr != nullptr,
+                             "operator* on a valueless shared_error");
+    return ptr->error;
+  }
+
+  // precondition: valueless_after_move() = false
+  constexpr auto operator->() const noexcept -> E const* {
+    RD_EXPECTED_PRECONDITION(ptr != nullptr,
+                             "operator-> on a valueless shared_error");
+    return std::addressof(ptr->error);
+  }
+
+  // The number of copies sharing the E. Without hardening, 0 when valueless.
+  //
+  // precondition: valueless_after_move() = false
+  [[nodiscard]] auto use_count() const noexcept -> std::size_t {
+    RD_EXPECTED_PRECONDITION(ptr != nullptr,
+                             "use_count() on a valueless shared_error");
+    return ptr != nullptr ? ptr->count.get() : 0;
+  }
+
+  // The rd::error_message of the E.
+  //
+  // precondition: valueless_after_move() = false
+  [[nodiscard]] auto message() const -> std::string {
+    RD_EXPECTED_PRECONDITION(ptr != nullptr,
+                             "message() on a valueless shared_error");
+    return rd::error_message(ptr->error);
+  }
+
+  [[nodiscard]] constexpr auto valueless_after_move() const noexcept -> bool {
+    return ptr == nullptr;
+  }
+
+  constexpr void swap(basic_shared_error& other) noexcept {
+    std::swap(ptr, other.ptr);
+  }
+
+  friend constexpr void swap(basic_shared_error& x,
+                             basic_shared_error& y) noexcept {
+    x.swap(y);
+  }
+
+  // equality operators compare the shared errors
+  //
+  // precondition: neither operand is valueless
+  template <class E2, bool Atomic2>
+  requires requires(E const& x, E2 const& y) {
+    { x == y } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(basic_shared_error const& x,
+                                   basic_shared_error<E2, Atomic2> const& y)
+      -> bool {
+    RD_EXPECTED_PRECONDITION(
+        !x.valueless_after_move() && !y.valueless_after_move(),
+        "operator== on a valueless shared_error");
+    return *x == *y;
+  }
+
+  // Self is deduced for the same reason as in expected's == with a value.
+  template <class Self, class G>
+  requires std::same_as<Self, basic_shared_error> &&
+      (!detail::is_shared_error<G>) &&
+      requires(E const& x, G const& y) {
+    { x == y } -> std::convertible_to<bool>;
+  }
+  friend constexpr auto operator==(Self const& x, G const& y) -> bool {
+    RD_EXPECTED_PRECONDITION(!x.valueless_after_move(),
+                             "operator== on a valueless shared_error");
+    return *x == y;
+  }
+
+ private:
+  using block = detail::shared_error_block<E, Atomic>;
+
+  block* ptr;
+};
+
+// Shares its E across threads.
+template <class E>
+using shared_error = basic_shared_error<E, true>;
+
+// Shares its E within one thread, without atomic operations.
+template <class E>
+using local_shared_error = basic_shared_error<E, false>;
+
+template <class E, bool Atomic>
+struct is_trivially_relocatable<basic_shared_error<E, Atomic>>
+    : std::true_type {};
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
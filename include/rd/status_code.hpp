@@ -0,0 +1,177 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <forward_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "expected.hpp"
+
+namespace rd {
+inline namespace RD_EXPECTED_ABI_NAMESPACE {
+
+// Describes a family of status codes. A domain is a single object, usually
+// constexpr, and is compared by address.
+class status_domain {
+ public:
+  [[nodiscard]] virtual auto name() const noexcept -> std::string_view = 0;
+
+  // Computed only when asked for, codes themselves carry no text.
+  [[nodiscard]] virtual auto message(int value) const -> std::string = 0;
+
+ protected:
+  constexpr status_domain() noexcept = default;
+  constexpr status_domain(status_domain const&) noexcept = default;
+  constexpr auto operator=(status_domain const&) noexcept
+      -> status_domain& = default;
+  ~status_domain() = default;
+};
+
+// Codes of std::errc, the portable errno values.
+struct errc_domain_t final : status_domain {
+  [[nodiscard]] auto name() const noexcept -> std::string_view override {
+    return "errc";
+  }
+
+  [[nodiscard]] auto message(int value) const -> std::string override {
+    return std::generic_category().message(value);
+  }
+};
+
+inline constexpr errc_domain_t errc_domain{};
+
+// Codes as set in errno by the operating system.
+struct errno_domain_t final : status_domain {
+  [[nodiscard]] auto name() const noexcept -> std::string_view override {
+    return "errno";
+  }
+
+  [[nodiscard]] auto message(int value) const -> std::string override {
+    return std::system_category().message(value);
+  }
+};
+
+inline constexpr errno_domain_t errno_domain{};
+
+namespace detail {
+// Stands in for error categories that have no domain of their own.
+struct category_domain final : status_domain {
+  explicit category_domain(std::error_category const& c) noexcept
+      : category(&c) {}
+
+  [[nodiscard]] auto name() const noexcept -> std::string_view override {
+    return category->name();
+  }
+
+  [[nodiscard]] auto message(int value) const -> std::string override {
+    return category->message(value);
+  }
+
+  std::error_category const* category;
+};
+
+// Domains are created once per category and live until the program ends.
+inline auto domain_of(std::error_category const& category)
+    -> status_domain const& {
+  if (category == std::generic_category()) {
+    return errc_domain;
+  }
+#ifndef _WIN32
+  // POSIX system error codes are errno values
+  if (category == std::system_category()) {
+    return errno_domain;
+  }
+#endif
+  static std::mutex mutex;
+  static std::forward_list<category_domain> domains;
+  std::scoped_lock lock(mutex);
+  for (auto const& domain : domains) {
+    if (*domain.category == category) {
+      return domain;
+    }
+  }
+  return domains.emplace_front(category);
+}
+}  // namespace detail
+
+// A trivially copyable error: a domain and an integer value within it. It is
+// two words, and expected<T, status_code> is no larger than status_code when
+// T fits in the first word. Messages are computed by the domain when asked
+// for.
+class status_code {
+ public:
+  constexpr status_code(status_domain const& domain, int value) noexcept
+      : val(value), dom(&domain) {}
+
+  constexpr status_code(std::errc e) noexcept  // NOLINT
+      : status_code(errc_domain, static_cast<int>(e)) {}
+
+  // Codes of categories other than the generic and system ones get a domain
+  // the first time they are seen, which takes a lock.
+  status_code(std::error_code const& ec)  // NOLINT
+      : status_code(detail::domain_of(ec.category()), ec.value()) {}
+
+  [[nodiscard]] constexpr auto domain() const noexcept
+      -> status_domain const& {
+    return *dom;
+  }
+
+  [[nodiscard]] constexpr auto value() const noexcept -> int { return val; }
+
+  [[nodiscard]] auto message() const -> std::string {
+    return dom->message(val);
+  }
+
+  // Equal codes have the same domain and value, no message is compared.
+  friend constexpr auto operator==(status_code const&, status_code const&)
+      -> bool = default;
+
+ private:
+  friend struct niche_traits<status_code>;
+
+  int val;
+  status_domain const* dom;
+};
+
+// The domain pointer is never odd.
+template <>
+struct niche_traits<status_code> {
+  static constexpr std::size_t offset =
+      offsetof(status_code, dom) +
+      (std::endian::native == std::endian::little
+           ? 0
+           : sizeof(status_domain const*) - 1);
+  static constexpr unsigned char mask = 1;
+  static constexpr unsigned char tag = 1;
+};
+
+}  // namespace RD_EXPECTED_ABI_NAMESPACE
+}  // namespace rd
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <string>
+
+// Counts calls of the replaceable global operator new, which the test
+// executable replaces in alloc_counter.cpp.
+namespace alloc_counter {
+
+auto allocations() noexcept -> std::size_t;
+
+// Number of allocations made since construction.
+class scope {
+ public:
+  scope() noexcept : start(allocations()) {}
+
+  [[nodiscard]] auto count() const noexcept -> std::size_t {
+    return allocations() - start;
+  }
+
+ private:
+  std::size_t start;
+};
+
+// Runs the block under REQUIRE_NO_ALLOC once, then checks it allocated
+// nothing.
+class no_alloc_scope : public scope {
+ public:
+  auto next() noexcept -> bool { return ++pass <= 2; }
+  [[nodiscard]] auto ran() const noexcept -> bool { return pass == 2; }
+
+ private:
+  int pass = 0;
+};
+
+// Long enough to never fit in the small string buffer, so that copying it
+// allocates.
+inline auto long_string(char c) -> std::string { return std::string(64, c); }
+
+}  // namespace alloc_counter
+
+// REQUIRE_NO_ALLOC { ... } fails the test if the block calls operator new.
+// Leaving the block early with break skips the check.
+#define REQUIRE_NO_ALLOC                                                    \
+  for (alloc_counter::no_alloc_scope no_alloc_scope_;                       \
+       no_alloc_scope_.next();)                                             \
+    if (no_alloc_scope_.ran()) {                                            \
+      REQUIRE_MESSAGE(no_alloc_scope_.count() == 0,                         \
+                      no_alloc_scope_.count() << " allocation(s)");         \
+    } else
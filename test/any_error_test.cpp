@@ -0,0 +1,167 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <array>
+#include <stdexcept>
+#include <system_error>
+
+#include "alloc_counter.hpp"
+#include "rd/any_error.hpp"
+#include "test_include.hpp"
+
+namespace {
+struct io_error {
+  int fd;
+
+  [[nodiscard]] auto message() const -> std::string {
+    return "io error on " + std::to_string(fd);
+  }
+};
+
+struct parse_error {
+  int line;
+  int column;
+};
+
+// Same layout as parse_error, still a different type.
+struct position {
+  int line;
+  int column;
+};
+
+struct large_error {
+  std::array<char, 256> detail{};
+  int code = 0;
+};
+
+struct counted {
+  counted() = default;
+  counted(counted const&) noexcept { ++copies; }
+  counted(counted&&) noexcept { ++moves; }
+  auto operator=(counted const&) -> counted& = default;
+  auto operator=(counted&&) -> counted& = default;
+  ~counted() { ++destructions; }
+
+  static inline int copies = 0;        // NOLINT
+  static inline int moves = 0;         // NOLINT
+  static inline int destructions = 0;  // NOLINT
+};
+
+auto read(int fd) -> rd::expected<int, rd::any_error> {
+  if (fd < 0) {
+    return rd::unexpected(io_error{fd});
+  }
+  return fd;
+}
+
+auto parse(int fd) -> rd::expected<int, rd::any_error> {
+  return read(fd).and_then([](int x) -> rd::expected<int, rd::any_error> {
+    if (x == 0) {
+      return rd::unexpected(parse_error{1, 2});
+    }
+    return x;
+  });
+}
+}  // namespace
+
+static_assert(rd::any_error::fits_inline<io_error>);
+static_assert(rd::any_error::fits_inline<std::string>);
+static_assert(!rd::any_error::fits_inline<large_error>);
+static_assert(std::is_nothrow_move_constructible_v<rd::any_error>);
+static_assert(sizeof(rd::basic_any_error<48>) > sizeof(rd::any_error));
+
+TEST_CASE("any_error: downcasting") {
+  rd::any_error e = io_error{3};
+  REQUIRE(e.error_as<io_error>() != nullptr);
+  REQUIRE(e.error_as<io_error>()->fd == 3);
+  REQUIRE(e.error_as<parse_error>() == nullptr);
+  e.error_as<io_error>()->fd = 4;
+  auto const& c = e;
+  REQUIRE(c.error_as<io_error>()->fd == 4);
+}
+
+TEST_CASE("any_error: types with the same layout stay distinct") {
+  rd::any_error e = parse_error{1, 2};
+  REQUIRE(e.error_as<parse_error>() != nullptr);
+  REQUIRE(e.error_as<position>() == nullptr);
+}
+
+TEST_CASE("any_error: messages") {
+  REQUIRE(rd::any_error(io_error{3}).message() == "io error on 3");
+  REQUIRE(rd::any_error(std::runtime_error("bad")).message() == "bad");
+  REQUIRE(rd::any_error(std::errc::io_error).message() ==
+          std::make_error_code(std::errc::io_error).message());
+  REQUIRE(rd::any_error(std::string("text")).message() == "text");
+  REQUIRE(rd::any_error(parse_error{}).message() == "unknown error");
+}
+
+TEST_CASE("any_error: errors cross layers without allocating") {
+  alloc_counter::scope scope;
+  auto io = parse(-1);
+  auto syntax = parse(0);
+  auto ok = parse(1);
+  REQUIRE(io.error().error_as<io_error>()->fd == -1);
+  REQUIRE(syntax.error().error_as<parse_error>()->column == 2);
+  REQUIRE(*ok == 1);
+  auto copy = io;
+  REQUIRE(copy.error().error_as<io_error>()->fd == -1);
+  REQUIRE(scope.count() == 0);
+}
+
+TEST_CASE("any_error: large errors fall back to the heap") {
+  auto fallbacks = rd::any_error_heap_fallbacks();
+  rd::any_error e = large_error{{}, 7};
+  REQUIRE(rd::any_error_heap_fallbacks() == fallbacks + 1);
+  REQUIRE(e.error_as<large_error>()->code == 7);
+  auto copy = e;
+  REQUIRE(rd::any_error_heap_fallbacks() == fallbacks + 2);
+  REQUIRE(copy.error_as<large_error>() != e.error_as<large_error>());
+  auto moved = std::move(e);
+  REQUIRE(rd::any_error_heap_fallbacks() == fallbacks + 2);
+  REQUIRE(moved.error_as<large_error>()->code == 7);
+  REQUIRE(e.valueless_after_move());  // NOLINT
+
+  rd::basic_any_error<512> big = large_error{};
+  REQUIRE(rd::any_error_heap_fallbacks() == fallbacks + 2);
+  REQUIRE(big.error_as<large_error>() != nullptr);
+}
+
+TEST_CASE("any_error: copy, move and destroy the stored error") {
+  counted::copies = counted::moves = counted::destructions = 0;
+  {
+    rd::any_error a{std::in_place_type<counted>};
+    rd::any_error b = a;
+    REQUIRE(counted::copies == 1);
+    rd::any_error c = std::move(a);
+    REQUIRE(counted::moves == 1);
+    b = c;
+    b = std::move(c);
+    swap(a, b);
+    REQUIRE(a.error_as<counted>() != nullptr);
+    REQUIRE(b.valueless_after_move());
+  }
+  REQUIRE(counted::destructions ==
+          1 + counted::copies + counted::moves);
+}
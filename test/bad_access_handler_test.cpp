@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <csignal>
+#include <cstdlib>
+#include <string>
+
+#include "death_test.hpp"
+#include "test_include.hpp"
+
+namespace {
+void exit_on_bad_access(rd::bad_expected_access<void> const& /*unused*/) {
+  std::_Exit(3);
+}
+}  // namespace
+
+TEST_CASE("bad access handler: installing handlers") {
+  auto const previous = rd::set_bad_access_handler(exit_on_bad_access);
+  REQUIRE(previous == rd::log_and_abort_on_bad_access);
+  REQUIRE(rd::get_bad_access_handler() == exit_on_bad_access);
+  REQUIRE(rd::set_bad_access_handler(nullptr) == exit_on_bad_access);
+  REQUIRE(rd::get_bad_access_handler() == rd::log_and_abort_on_bad_access);
+}
+
+TEST_CASE("bad access handler: assignment works without rollback") {
+  rd::expected<std::string, std::string> e{rd::unexpect, "error"};
+  e = std::string("value");
+  REQUIRE(e.value() == "value");
+  e = rd::unexpected<std::string>("error");
+  REQUIRE(e.error() == "error");
+
+  rd::expected<std::string, std::string> other = "other";
+  e.swap(other);
+  REQUIRE(e.value() == "other");
+  REQUIRE(other.error() == "error");
+}
+
+#if defined(RD_EXPECTED_NO_EXCEPTIONS) && HAS_DEATH_TESTS
+TEST_CASE("bad access handler: value() calls the handler") {
+  int const status = run_in_child([] {
+    rd::set_bad_access_handler(exit_on_bad_access);
+    rd::expected<int, std::string> e{rd::unexpect, "error"};
+    static_cast<void>(e.value());
+  });
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 3);
+
+  int const void_status = run_in_child([] {
+    rd::set_bad_access_handler(exit_on_bad_access);
+    rd::expected<void, int> e{rd::unexpect, 1};
+    e.value();
+  });
+  REQUIRE(WIFEXITED(void_status));
+  REQUIRE(WEXITSTATUS(void_status) == 3);
+}
+
+TEST_CASE("bad access handler: the program is aborted by default") {
+  int const status = run_in_child([] {
+    rd::expected<int, int> e{rd::unexpect, 1};
+    static_cast<void>(e.value());
+  });
+  REQUIRE(WIFSIGNALED(status));
+  REQUIRE(WTERMSIG(status) == SIGABRT);
+}
+
+TEST_CASE("bad access handler: the program is aborted if the handler returns") {
+  int const status = run_in_child([] {
+    rd::set_bad_access_handler(
+        [](rd::bad_expected_access<void> const& /*unused*/) {});
+    rd::expected<int, int> e{rd::unexpect, 1};
+    static_cast<void>(e.value());
+  });
+  REQUIRE(WIFSIGNALED(status));
+  REQUIRE(WTERMSIG(status) == SIGABRT);
+}
+#endif
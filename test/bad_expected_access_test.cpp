@@ -22,6 +22,8 @@
  * SOFTWARE.
  */
 
+#include <string_view>
+
 #include "test_include.hpp"
 
 TEST_CASE("error constructor") {
@@ -31,5 +33,5 @@ TEST_CASE("error constructor") {
 
 TEST_CASE("what test") {
   rd::bad_expected_access<int> ex(2);
-  REQUIRE(ex.what() == "bad expected access");
+  REQUIRE(std::string_view(ex.what()) == "bad expected access");
 }
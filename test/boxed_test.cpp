@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "rd/boxed.hpp"
+#include "test_include.hpp"
+
+namespace {
+struct rich_error {
+  explicit rich_error(std::string msg) : message(std::move(msg)) {}
+
+  friend auto operator==(rich_error const&, rich_error const&)
+      -> bool = default;
+
+  std::string message;
+  std::vector<std::string> context;
+  char detail[128]{};  // NOLINT
+};
+
+using result = rd::expected<int, rd::boxed<rich_error>>;
+}  // namespace
+
+static_assert(sizeof(rd::boxed<rich_error>) == sizeof(rich_error*));
+static_assert(sizeof(result) <= 2 * sizeof(void*));
+static_assert(rd::is_trivially_relocatable_v<result>);
+static_assert(std::is_nothrow_move_constructible_v<result>);
+
+TEST_CASE("boxed: construction") {
+  rd::boxed<rich_error> b{std::in_place, "failed"};
+  REQUIRE(b->message == "failed");
+  REQUIRE((*b).message == "failed");
+  REQUIRE_FALSE(b.valueless_after_move());
+
+  rd::boxed<std::string> s = std::string("text");
+  REQUIRE(*s == "text");
+}
+
+TEST_CASE("boxed: copy is deep") {
+  rd::boxed<std::string> a{std::in_place, "a"};
+  rd::boxed<std::string> b = a;
+  *b = "b";
+  REQUIRE(*a == "a");
+  a = b;
+  REQUIRE(*a == "b");
+  REQUIRE(&*a != &*b);
+}
+
+TEST_CASE("boxed: move steals the pointer") {
+  rd::boxed<std::string> a{std::in_place, "a"};
+  auto const* address = &*a;
+  alloc_counter::scope scope;
+  rd::boxed<std::string> b = std::move(a);
+  REQUIRE(&*b == address);
+  REQUIRE(a.valueless_after_move());  // NOLINT
+  a = std::move(b);
+  REQUIRE(&*a == address);
+  REQUIRE(scope.count() == 0);
+}
+
+TEST_CASE("boxed: copy assignment to a moved-from box") {
+  rd::boxed<std::string> a{std::in_place, "a"};
+  rd::boxed<std::string> b = std::move(a);
+  a = b;
+  REQUIRE(*a == "a");
+}
+
+TEST_CASE("boxed: equality") {
+  rd::boxed<std::string> a{std::in_place, "a"};
+  rd::boxed<std::string> b{std::in_place, "a"};
+  REQUIRE(a == b);
+  REQUIRE(a == std::string("a"));
+  REQUIRE(std::string("b") != a);
+}
+
+TEST_CASE("boxed: as error of expected") {
+  result ok = 1;
+  REQUIRE(*ok == 1);
+
+  result err = rd::unexpected(rich_error("failed"));
+  REQUIRE(err.error()->message == "failed");
+  REQUIRE(err == rd::unexpected(rich_error("failed")));
+
+  result failed{rd::unexpect, "failed"};
+  REQUIRE(failed == err);
+}
+
+TEST_CASE("boxed: moving the error path doesn't allocate") {
+  result err{rd::unexpect, "failed"};
+  alloc_counter::scope scope;
+  auto next = std::move(err)
+                  .and_then([](int x) -> result { return x + 1; })
+                  .transform([](int x) { return x * 2; });
+  result moved = std::move(next);
+  REQUIRE(scope.count() == 0);
+  REQUIRE(moved.error()->message == "failed");
+}
+
+TEST_CASE("boxed: transform_error to boxed") {
+  rd::expected<int, std::string> err{rd::unexpect, "failed"};
+  auto boxed = err.transform_error(
+      [](std::string const& s) { return rd::boxed<rich_error>(s); });
+  REQUIRE(boxed.error()->message == "failed");
+}
@@ -0,0 +1,94 @@
+# MIT License
+# 
+# Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Checks the code generated for code_size.cpp: instructions on the hot path
+# of each function (excluding the .cold parts GCC splits off), and in the
+# whole object. Run as
+#   cmake -DOBJDUMP=<objdump> -DOBJECT=<code_size.o> -P check_code_size.cmake
+
+# Hot path instructions per function.
+set(hot_budgets
+    value_int_int 6
+    value_int_errc 6
+    value_int_string 6
+    value_int_big 6
+    value_string_string 6
+    value_moved_string 6
+    value_void_string 5
+    value_void_big 5
+    value_ref_string 6
+    sum_values 18)
+
+# Instructions of the whole object, cold paths and helpers included.
+set(total_budget 1200)
+
+execute_process(
+  COMMAND ${OBJDUMP} -d --no-show-raw-insn ${OBJECT}
+  OUTPUT_VARIABLE disassembly
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${OBJDUMP} failed on ${OBJECT}")
+endif()
+
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(function "")
+set(total 0)
+foreach(line IN LISTS lines)
+  if(line MATCHES "^[0-9a-f]+ <([^>]+)>:$")
+    set(function "${CMAKE_MATCH_1}")
+    string(MAKE_C_IDENTIFIER "${function}" id)
+    set(count_${id} 0)
+  elseif(line MATCHES "^ +[0-9a-f]+:\t" AND NOT line MATCHES "\tnop")
+    math(EXPR total "${total} + 1")
+    math(EXPR count_${id} "${count_${id}} + 1")
+  endif()
+endforeach()
+
+set(failed FALSE)
+list(LENGTH hot_budgets length)
+math(EXPR last "${length} - 1")
+foreach(i RANGE 0 ${last} 2)
+  math(EXPR j "${i} + 1")
+  list(GET hot_budgets ${i} function)
+  list(GET hot_budgets ${j} budget)
+  if(NOT DEFINED count_${function})
+    message(SEND_ERROR "${function} not found in ${OBJECT}")
+    set(failed TRUE)
+    continue()
+  endif()
+  message(STATUS "${function}: ${count_${function}} instructions "
+                 "(budget ${budget})")
+  if(count_${function} GREATER budget)
+    set(failed TRUE)
+  endif()
+endforeach()
+
+message(STATUS "total: ${total} instructions (budget ${total_budget})")
+if(total GREATER total_budget)
+  set(failed TRUE)
+endif()
+
+if(failed)
+  message(FATAL_ERROR "code size over budget")
+endif()
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Representative instantiations for the code size test. Each function is a
+// hot path calling into expected; failure paths should be out of line.
+
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "rd/expected.hpp"
+
+namespace {
+struct big_error {
+  std::string what;
+  std::vector<int> trace;
+};
+}  // namespace
+
+extern "C" {
+auto value_int_int(rd::expected<int, int>& e) -> int { return e.value(); }
+
+auto value_int_errc(rd::expected<int, std::errc>& e) -> int {
+  return e.value();
+}
+
+auto value_int_string(rd::expected<int, std::string>& e) -> int {
+  return e.value();
+}
+
+auto value_int_big(rd::expected<int, big_error>& e) -> int {
+  return e.value();
+}
+
+auto value_string_string(rd::expected<std::string, std::string>& e)
+    -> std::size_t {
+  return e.value().size();
+}
+
+auto value_moved_string(rd::expected<int, std::string>&& e) -> int {
+  return std::move(e).value();
+}
+
+void value_void_string(rd::expected<void, std::string>& e) { e.value(); }
+
+void value_void_big(rd::expected<void, big_error>& e) { e.value(); }
+
+auto value_ref_string(rd::expected<int&, std::string>& e) -> int {
+  return e.value();
+}
+
+auto sum_values(std::vector<rd::expected<int, std::string>>& v) -> int {
+  int sum = 0;
+  for (auto& e : v) {
+    sum += e.value();
+  }
+  return sum;
+}
+
+void assign_string(rd::expected<std::string, std::string>& e,
+                   std::string const& s) {
+  e = s;
+}
+
+void assign_error(rd::expected<std::vector<int>, big_error>& e,
+                  rd::unexpected<big_error> const& u) {
+  e = u;
+}
+
+void swap_strings(rd::expected<std::string, std::vector<int>>& x,
+                  rd::expected<std::string, std::vector<int>>& y) {
+  x.swap(y);
+}
+}
@@ -0,0 +1,112 @@
+# MIT License
+# 
+# Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Checks the code generated for the probes in codegen.cpp against their
+# hand-written tagged union twins. Every probe has to
+#   - take and return everything in registers: no memory operands at all,
+#     so no result returned through a hidden pointer and no stack spills,
+#   - call nothing, memcpy included,
+#   - stay within slack instructions of its twin.
+# Run as
+#   cmake -DOBJDUMP=<objdump> -DOBJECT=<codegen.o> -P check_codegen.cmake
+
+set(probes
+    make_value
+    make_error
+    checked_divide
+    wide_checked_divide
+    two_transforms
+    and_then_divide
+    value_or_zero)
+
+# Instructions a probe may take over its twin; register allocation and block
+# order differ between the two.
+set(slack 4)
+
+execute_process(
+  COMMAND ${OBJDUMP} -d -C --no-show-raw-insn ${OBJECT}
+  OUTPUT_VARIABLE disassembly
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${OBJDUMP} failed on ${OBJECT}")
+endif()
+
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(id "")
+foreach(line IN LISTS lines)
+  # Only the probes, by their demangled names: probes::make_value(int).
+  if(line MATCHES "^[0-9a-f]+ <probes::([a-z_]+)\\(.*>:$")
+    set(id "${CMAKE_MATCH_1}")
+    set(count_${id} 0)
+    set(memory_${id} "")
+    set(calls_${id} "")
+  elseif(line MATCHES "^[0-9a-f]+ <.*>:$")
+    set(id "")
+  elseif(id AND line MATCHES "^ +[0-9a-f]+:\t(.*)$")
+    set(instruction "${CMAKE_MATCH_1}")
+    # Padding between functions.
+    if(instruction MATCHES "nop|^xchg +%ax,%ax$")
+      continue()
+    endif()
+    math(EXPR count_${id} "${count_${id}} + 1")
+    if(instruction MATCHES "\\(%|^push|^pop"
+       AND NOT instruction MATCHES "^lea")
+      list(APPEND memory_${id} "${instruction}")
+    endif()
+    if(instruction MATCHES "^call|memcpy")
+      list(APPEND calls_${id} "${instruction}")
+    endif()
+  endif()
+endforeach()
+
+set(failed FALSE)
+foreach(probe IN LISTS probes)
+  if(NOT DEFINED count_${probe} OR NOT DEFINED count_tagged_${probe})
+    message(SEND_ERROR "${probe} or its twin not found in ${OBJECT}")
+    set(failed TRUE)
+    continue()
+  endif()
+
+  message(STATUS "${probe}: ${count_${probe}} instructions "
+                 "(tagged union: ${count_tagged_${probe}})")
+  math(EXPR budget "${count_tagged_${probe}} + ${slack}")
+  if(count_${probe} GREATER budget)
+    message(SEND_ERROR "${probe}: more than ${slack} instructions over the "
+                       "tagged union")
+    set(failed TRUE)
+  endif()
+  foreach(instruction IN LISTS memory_${probe})
+    message(SEND_ERROR "${probe}: accesses memory: ${instruction}")
+    set(failed TRUE)
+  endforeach()
+  foreach(instruction IN LISTS calls_${probe})
+    message(SEND_ERROR "${probe}: calls out: ${instruction}")
+    set(failed TRUE)
+  endforeach()
+endforeach()
+
+if(failed)
+  message(FATAL_ERROR "code generated for expected regressed")
+endif()
@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Probes for the code generated for expected. Every probe has a twin written
+// against a hand-written tagged union; check_codegen.cmake compares their
+// disassembly. The static_asserts below pin the layout the probes rely on.
+
+#include <cstdint>
+#include <system_error>
+#include <type_traits>
+
+#include "rd/expected.hpp"
+
+// The probes return class types, so they have C++ linkage in a namespace of
+// their own, tagged union included; check_codegen.cmake reads the demangled
+// names.
+namespace probes {
+using result = rd::expected<int, std::errc>;
+using wide_result = rd::expected<std::int64_t, std::errc>;
+
+// What expected should compile to.
+template <class T, class E>
+struct tagged {
+  union {
+    T value;
+    E error;
+  };
+  bool has_value;
+};
+
+using tagged_result = tagged<int, std::errc>;
+using tagged_wide_result = tagged<std::int64_t, std::errc>;
+
+template <class Expected, class Tagged>
+constexpr bool same_layout = sizeof(Expected) == sizeof(Tagged) &&
+                             alignof(Expected) == alignof(Tagged);
+
+static_assert(same_layout<result, tagged_result>);
+static_assert(same_layout<wide_result, tagged_wide_result>);
+static_assert(same_layout<rd::expected<char, std::errc>,
+                          tagged<char, std::errc>>);
+static_assert(sizeof(rd::expected<void, std::errc>) ==
+              sizeof(tagged<char, std::errc>));
+
+// Triviality decides whether the ABI returns the object in registers.
+static_assert(std::is_trivially_copyable_v<result>);
+static_assert(std::is_trivially_copyable_v<wide_result>);
+static_assert(std::is_trivially_copyable_v<rd::expected<void, std::errc>>);
+static_assert(std::is_trivially_destructible_v<result>);
+static_assert(std::is_trivially_copy_constructible_v<result>);
+static_assert(std::is_trivially_move_constructible_v<result>);
+static_assert(std::is_trivially_copy_assignable_v<result>);
+static_assert(std::is_trivially_move_assignable_v<result>);
+
+// Returning a value or an error.
+auto make_value(int x) -> result { return x; }
+
+auto tagged_make_value(int x) -> tagged_result {
+  tagged_result r;
+  r.value = x;
+  r.has_value = true;
+  return r;
+}
+
+auto make_error(std::errc e) -> result { return rd::unexpected(e); }
+
+auto tagged_make_error(std::errc e) -> tagged_result {
+  tagged_result r;
+  r.error = e;
+  r.has_value = false;
+  return r;
+}
+
+auto checked_divide(int a, int b) -> result {
+  if (b == 0) {
+    return rd::unexpected(std::errc::invalid_argument);
+  }
+  return a / b;
+}
+
+auto tagged_checked_divide(int a, int b) -> tagged_result {
+  tagged_result r;
+  if (b == 0) {
+    r.error = std::errc::invalid_argument;
+    r.has_value = false;
+    return r;
+  }
+  r.value = a / b;
+  r.has_value = true;
+  return r;
+}
+
+auto wide_checked_divide(std::int64_t a, std::int64_t b) -> wide_result {
+  if (b == 0) {
+    return rd::unexpected(std::errc::invalid_argument);
+  }
+  return a / b;
+}
+
+auto tagged_wide_checked_divide(std::int64_t a, std::int64_t b)
+    -> tagged_wide_result {
+  tagged_wide_result r;
+  if (b == 0) {
+    r.error = std::errc::invalid_argument;
+    r.has_value = false;
+    return r;
+  }
+  r.value = a / b;
+  r.has_value = true;
+  return r;
+}
+
+// Chaining members.
+auto two_transforms(result r) -> result {
+  return r.transform([](int x) { return x + 1; }).transform([](int x) {
+    return x * 2;
+  });
+}
+
+auto tagged_two_transforms(tagged_result r) -> tagged_result {
+  if (r.has_value) {
+    r.value = (r.value + 1) * 2;
+  }
+  return r;
+}
+
+auto and_then_divide(result r, int b) -> result {
+  return r.and_then([b](int a) { return checked_divide(a, b); });
+}
+
+auto tagged_and_then_divide(tagged_result r, int b) -> tagged_result {
+  if (!r.has_value) {
+    return r;
+  }
+  return tagged_checked_divide(r.value, b);
+}
+
+auto value_or_zero(result r) -> int { return r.value_or(0); }
+
+auto tagged_value_or_zero(tagged_result r) -> int {
+  return r.has_value ? r.value : 0;
+}
+}  // namespace probes
@@ -0,0 +1,171 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <map>
+#include <ranges>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "rd/collect.hpp"
+#include "test_include.hpp"
+
+namespace {
+using result = rd::expected<std::string, int>;
+
+auto parse(int i) -> rd::expected<int, int> {
+  if (i < 0) {
+    return rd::unexpected(i);
+  }
+  return i;
+}
+
+// Counts the elements it is asked to produce.
+auto counted(int* produced) {
+  return [produced](int i) {
+    ++*produced;
+    return parse(i);
+  };
+}
+}  // namespace
+
+TEST_CASE("collect with values") {
+  std::vector<result> v{std::string("a"), std::string("b")};
+  auto r = rd::collect<std::vector<std::string>>(v);
+  REQUIRE(r.has_value());
+  REQUIRE(*r == std::vector<std::string>{"a", "b"});
+  REQUIRE(*v[0] == "a");
+}
+
+TEST_CASE("collect returns the first error") {
+  std::vector<result> v{std::string("a"), rd::unexpected(1),
+                        rd::unexpected(2)};
+  auto r = rd::collect<std::vector<std::string>>(v);
+  REQUIRE(!r.has_value());
+  REQUIRE(r.error() == 1);
+}
+
+TEST_CASE("collect stops at the first error") {
+  int produced = 0;
+  auto inputs = std::vector<int>{1, -2, 3, 4};
+  auto r = rd::collect<std::vector<int>>(
+      inputs | std::views::transform(counted(&produced)));
+  REQUIRE(r.error() == -2);
+  REQUIRE(produced == 2);
+}
+
+TEST_CASE("collect of an empty range") {
+  std::vector<result> v;
+  auto r = rd::collect<std::vector<std::string>>(v);
+  REQUIRE(r.has_value());
+  REQUIRE(r->empty());
+}
+
+TEST_CASE("collect moves out of an rvalue range") {
+  std::vector<result> v{alloc_counter::long_string('a'),
+                        alloc_counter::long_string('b')};
+  std::size_t allocations = 0;
+  {
+    alloc_counter::scope scope;
+    auto r = rd::collect<std::vector<std::string>>(std::move(v));
+    allocations = scope.count();
+    REQUIRE(r->size() == 2);
+  }
+  // Only the reserved buffer.
+  REQUIRE(allocations == 1);
+  REQUIRE(v[0]->empty());  // NOLINT
+}
+
+TEST_CASE("collect doesn't move out of a view") {
+  std::vector<result> v{alloc_counter::long_string('a')};
+  auto r = rd::collect<std::vector<std::string>>(std::views::all(v));
+  REQUIRE(r->front() == alloc_counter::long_string('a'));
+  REQUIRE(*v[0] == alloc_counter::long_string('a'));
+}
+
+TEST_CASE("collect reserves for sized ranges") {
+  std::vector<rd::expected<int, int>> v(1000, 1);
+  alloc_counter::scope scope;
+  auto r = rd::collect<std::vector<int>>(v);
+  REQUIRE(r->size() == 1000);
+  REQUIRE(r->capacity() == 1000);
+  REQUIRE(scope.count() == 1);
+}
+
+TEST_CASE("collect of a lazy range") {
+  auto r = rd::collect<std::vector<int>>(std::views::iota(0, 5) |
+                                         std::views::transform(parse));
+  REQUIRE(*r == std::vector<int>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("collect into other containers") {
+  std::vector<result> v{std::string("b"), std::string("a"), std::string("b")};
+  auto set = rd::collect<std::set<std::string>>(v);
+  REQUIRE(*set == std::set<std::string>{"a", "b"});
+  auto list = rd::collect<std::list<std::string>>(v);
+  REQUIRE(list->size() == 3);
+
+  std::vector<rd::expected<std::pair<int const, int>, int>> pairs{
+      std::pair<int const, int>{1, 2}};
+  auto map = rd::collect<std::map<int, int>>(pairs);
+  REQUIRE(map->at(1) == 2);
+}
+
+TEST_CASE("collect is usable in constant expressions") {
+  constexpr auto sum = [] {
+    std::vector<rd::expected<int, int>> v{1, 2, 3};
+    auto r = rd::collect<std::vector<int>>(v);
+    int s = 0;
+    for (int x : *r) {
+      s += x;
+    }
+    return s;
+  }();
+  static_assert(sum == 6);
+}
+
+TEST_CASE("collect_all_errors with values") {
+  auto r = rd::collect_all_errors<std::vector<int>>(
+      std::views::iota(0, 3) | std::views::transform(parse));
+  REQUIRE(*r == std::vector<int>{0, 1, 2});
+}
+
+TEST_CASE("collect_all_errors gathers every error") {
+  int produced = 0;
+  auto inputs = std::vector<int>{1, -2, 3, -4};
+  auto r = rd::collect_all_errors<std::vector<int>>(
+      inputs | std::views::transform(counted(&produced)));
+  REQUIRE(r.error() == std::vector<int>{-2, -4});
+  REQUIRE(produced == 4);
+}
+
+TEST_CASE("collect_all_errors into a given error container") {
+  std::vector<result> v{rd::unexpected(2), rd::unexpected(1),
+                        rd::unexpected(2)};
+  auto r = rd::collect_all_errors<std::vector<std::string>, std::set<int>>(v);
+  REQUIRE(r.error() == std::set<int>{1, 2});
+}
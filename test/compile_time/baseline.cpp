@@ -0,0 +1,202 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The baseline for the compile time test: the operations of compile_time.cpp
+// on a bare tagged union, instantiated as often. The test compares the two
+// compile times, so that the budget follows the speed of the machine.
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef INSTANTIATIONS
+#define INSTANTIATIONS 200
+#endif
+
+namespace {
+template <class E>
+struct failure {
+  E error;
+};
+
+template <class T, class E>
+class result {
+  union {
+    T val;
+    E unex;
+  };
+  bool has_val;
+
+ public:
+  result(T v) : val(std::move(v)), has_val(true) {}  // NOLINT
+  result(failure<E> f) : unex(std::move(f.error)), has_val(false) {}  // NOLINT
+
+  template <class U>
+  result(result<U, E> const& rhs) : has_val(rhs.has_value()) {  // NOLINT
+    if (has_val) {
+      std::construct_at(std::addressof(val), *rhs);
+    } else {
+      std::construct_at(std::addressof(unex), rhs.error());
+    }
+  }
+
+  template <class U, class F>
+  friend class result;
+
+  template <class U>
+  result(result<U, E>&& rhs) : has_val(rhs.has_val) {  // NOLINT
+    if (has_val) {
+      std::construct_at(std::addressof(val), std::move(rhs.val));
+    } else {
+      std::construct_at(std::addressof(unex), std::move(rhs.unex));
+    }
+  }
+
+  result(result const& rhs) : has_val(rhs.has_val) {
+    if (has_val) {
+      std::construct_at(std::addressof(val), rhs.val);
+    } else {
+      std::construct_at(std::addressof(unex), rhs.unex);
+    }
+  }
+
+  auto operator=(result const& rhs) -> result& {
+    if (this != &rhs) {
+      this->~result();
+      std::construct_at(this, rhs);
+    }
+    return *this;
+  }
+
+  ~result() {
+    if (has_val) {
+      std::destroy_at(std::addressof(val));
+    } else {
+      std::destroy_at(std::addressof(unex));
+    }
+  }
+
+  [[nodiscard]] auto has_value() const -> bool { return has_val; }
+  auto operator*() const -> T const& { return val; }
+  [[nodiscard]] auto error() const -> E const& { return unex; }
+
+  template <class F>
+  auto transform(F f) const -> result<decltype(f(val)), E> {
+    if (has_val) {
+      return f(val);
+    }
+    return failure<E>{unex};
+  }
+
+  template <class F>
+  auto and_then(F f) const -> decltype(f(val)) {
+    if (has_val) {
+      return f(val);
+    }
+    return failure<E>{unex};
+  }
+
+  template <class F>
+  auto or_else(F f) const -> decltype(f(unex)) {
+    if (has_val) {
+      return val;
+    }
+    return f(unex);
+  }
+
+  template <class F>
+  auto transform_error(F f) const -> result<T, decltype(f(unex))> {
+    if (has_val) {
+      return val;
+    }
+    return failure<decltype(f(unex))>{f(unex)};
+  }
+
+  auto value_or(T v) const -> T { return has_val ? val : v; }
+
+  void swap(result& other) {
+    result tmp(other);
+    other = *this;
+    *this = tmp;
+  }
+
+  friend auto operator==(result const& x, result const& y) -> bool {
+    if (x.has_val != y.has_val) {
+      return false;
+    }
+    return x.has_val ? x.val == y.val : x.unex == y.unex;
+  }
+};
+
+template <std::size_t I>
+struct value {
+  int v;
+  auto operator==(value const&) const -> bool = default;
+};
+
+template <std::size_t I>
+struct other_value {
+  int v;
+  operator value<I>() const { return {v}; }  // NOLINT
+};
+
+template <std::size_t I>
+struct error {
+  int code;
+  auto operator==(error const&) const -> bool = default;
+};
+
+template <std::size_t I>
+auto exercise(int x) -> int {
+  using res = result<value<I>, error<I>>;
+  using other = result<other_value<I>, error<I>>;
+  other o{other_value<I>{x}};
+  res r{o};
+  res m{std::move(o)};
+  r = m;
+  r = failure<error<I>>{error<I>{x}};
+  auto t = m.transform([](value<I> v) { return v.v + 1; })
+               .and_then([](int v) { return result<int, error<I>>(v); })
+               .or_else([](error<I> e) {
+                 return result<int, error<I>>(e.code);
+               })
+               .transform_error([](error<I> e) { return e.code; });
+  result<bool, error<I>> v{true};  // stands in for expected<void, E>
+  v = failure<error<I>>{error<I>{x}};
+  r.swap(m);
+  return t.value_or(0) + r.value_or(value<I>{0}).v +
+         static_cast<int>(v.has_value()) + static_cast<int>(r == m);
+}
+
+template <std::size_t... I>
+auto exercise_all(int x, std::index_sequence<I...> /*unused*/) -> int {
+  return (0 + ... + exercise<I>(x));
+}
+}  // namespace
+
+auto compile_time(int x) -> int {
+  return exercise_all(x, std::make_index_sequence<INSTANTIATIONS>{});
+}
@@ -0,0 +1,65 @@
+# MIT License
+# 
+# Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Checks how long the compiler takes to instantiate expected and its members
+# for INSTANTIATIONS distinct value and error types, against BASELINE: the
+# same operations on a bare tagged union, compiled in the same run. Comparing
+# the two keeps the check independent of the speed of the machine. Only the
+# front end runs: that's where the cost of the header's templates is.
+# Run as
+#   cmake -DCOMPILER=<c++> -DSOURCE=<compile_time.cpp>
+#         -DBASELINE=<baseline.cpp> -DINCLUDE=<include dir>
+#         -DINSTANTIATIONS=<n> -DMAX_RATIO=<r> -P check_compile_time.cmake
+
+# Times a compilation of source with the given definitions, in ms.
+function(time_compilation out source)
+  string(TIMESTAMP start "%s%f")
+  execute_process(
+    COMMAND ${COMPILER} -std=c++20 -fsyntax-only -I${INCLUDE} ${ARGN}
+            ${source}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE errors)
+  string(TIMESTAMP stop "%s%f")
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${source} doesn't compile:\n${errors}")
+  endif()
+  math(EXPR elapsed "(${stop} - ${start}) / 1000")
+  set(${out} ${elapsed} PARENT_SCOPE)
+endfunction()
+
+# Parsing the header alone, to report the cost per instantiation.
+time_compilation(header ${SOURCE} -DINSTANTIATIONS=0)
+time_compilation(baseline ${BASELINE} -DINSTANTIATIONS=${INSTANTIATIONS})
+time_compilation(total ${SOURCE} -DINSTANTIATIONS=${INSTANTIATIONS})
+
+math(EXPR per_instantiation "(${total} - ${header}) / ${INSTANTIATIONS}")
+# In hundredths, as CMake only has integer arithmetic.
+math(EXPR ratio "${total} * 100 / ${baseline}")
+math(EXPR max_ratio "${MAX_RATIO} * 100")
+message(STATUS "${INSTANTIATIONS} instantiations: ${total} ms "
+               "(header: ${header} ms, ${per_instantiation} ms each), "
+               "baseline: ${baseline} ms, ratio ${ratio}/100 "
+               "(at most ${MAX_RATIO})")
+if(ratio GREATER max_ratio)
+  message(FATAL_ERROR "compile time over budget")
+endif()
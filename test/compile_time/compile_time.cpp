@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Instantiates expected and its members for INSTANTIATIONS distinct pairs of
+// value and error types, for the compile time test.
+
+#include <cstddef>
+#include <utility>
+
+#include "rd/expected.hpp"
+
+#ifndef INSTANTIATIONS
+#define INSTANTIATIONS 200
+#endif
+
+namespace {
+template <std::size_t I>
+struct value {
+  int v;
+  auto operator==(value const&) const -> bool = default;
+};
+
+template <std::size_t I>
+struct other_value {
+  int v;
+  operator value<I>() const { return {v}; }  // NOLINT
+};
+
+template <std::size_t I>
+struct error {
+  int code;
+  auto operator==(error const&) const -> bool = default;
+};
+
+template <std::size_t I>
+auto exercise(int x) -> int {
+  using result = rd::expected<value<I>, error<I>>;
+  using other = rd::expected<other_value<I>, error<I>>;
+  other o{other_value<I>{x}};
+  result r{o};
+  result m{std::move(o)};
+  r = m;
+  r = rd::unexpected(error<I>{x});
+  auto t = m.transform([](value<I> v) { return v.v + 1; })
+               .and_then([](int v) { return rd::expected<int, error<I>>(v); })
+               .or_else([](error<I> e) {
+                 return rd::expected<int, error<I>>(e.code);
+               })
+               .transform_error([](error<I> e) { return e.code; });
+  rd::expected<void, error<I>> v;
+  v = rd::unexpected(error<I>{x});
+  r.swap(m);
+  return t.value_or(0) + r.value_or(value<I>{0}).v +
+         static_cast<int>(v.has_value()) + static_cast<int>(r == m);
+}
+
+template <std::size_t... I>
+auto exercise_all(int x, std::index_sequence<I...> /*unused*/) -> int {
+  return (0 + ... + exercise<I>(x));
+}
+}  // namespace
+
+auto compile_time(int x) -> int {
+  return exercise_all(x, std::make_index_sequence<INSTANTIATIONS>{});
+}
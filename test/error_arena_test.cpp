@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+
+#include "alloc_counter.hpp"
+#include "rd/boxed.hpp"
+#include "rd/error_arena.hpp"
+#include "test_include.hpp"
+
+namespace {
+struct pmr_error {
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
+  explicit pmr_error(std::string_view msg,
+                     allocator_type alloc = rd::error_allocator())
+      : message(msg, alloc) {}
+
+  pmr_error(pmr_error const& other, allocator_type alloc)
+      : message(other.message, alloc) {}
+
+  std::pmr::string message;
+};
+
+// Forwards to new and delete and keeps count.
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocated = 0;    // NOLINT
+  std::size_t deallocated = 0;  // NOLINT
+
+ private:
+  auto do_allocate(std::size_t bytes, std::size_t align) -> void* override {
+    ++allocated;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    ++deallocated;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  [[nodiscard]] auto do_is_equal(memory_resource const& other) const noexcept
+      -> bool override {
+    return this == &other;
+  }
+};
+
+// Longer than any small string buffer.
+constexpr std::string_view long_message =
+    "a message long enough to need an allocation of its own";
+}  // namespace
+
+TEST_CASE("error_arena: current arena") {
+  REQUIRE(rd::error_arena::current() == std::pmr::get_default_resource());
+  {
+    rd::error_arena outer;
+    REQUIRE(rd::error_arena::current() == &outer);
+    {
+      rd::error_arena inner;
+      REQUIRE(rd::error_arena::current() == &inner);
+    }
+    REQUIRE(rd::error_arena::current() == &outer);
+  }
+  REQUIRE(rd::error_arena::current() == std::pmr::get_default_resource());
+}
+
+TEST_CASE("error_arena: errors draw from the arena") {
+  counting_resource upstream;
+  {
+    rd::error_arena arena(&upstream);
+    rd::expected<int, pmr_error> e{rd::unexpect, long_message};
+    REQUIRE(e.error().message == long_message);
+    REQUIRE(e.error().message.get_allocator().resource() == &arena);
+    REQUIRE(upstream.allocated == 1);
+
+    rd::expected<int, rd::boxed<pmr_error>> boxed{rd::unexpect, long_message};
+    REQUIRE(boxed.error()->message == long_message);
+    REQUIRE(boxed.error()->message.get_allocator().resource() == &arena);
+    REQUIRE(upstream.allocated == 1);
+    REQUIRE(upstream.deallocated == 0);
+  }
+  REQUIRE(upstream.deallocated == upstream.allocated);
+}
+
+TEST_CASE("error_arena: buffer on the stack doesn't allocate") {
+  alignas(std::max_align_t) std::byte buffer[1024];
+  alloc_counter::scope scope;
+  {
+    rd::error_arena arena(buffer, sizeof(buffer));
+    rd::expected<int, rd::boxed<pmr_error>> e =
+        rd::unexpected(pmr_error(long_message));
+    auto copy = e;
+    REQUIRE(copy.error()->message == long_message);
+    REQUIRE(&*copy.error() != &*e.error());
+  }
+  REQUIRE(scope.count() == 0);
+}
+
+TEST_CASE("error_arena: boxed outside of an arena uses the default resource") {
+  counting_resource resource;
+  auto* previous = std::pmr::set_default_resource(&resource);
+  {
+    rd::boxed<int> b{std::in_place, 1};
+    REQUIRE(*b == 1);
+    REQUIRE(resource.allocated == 1);
+  }
+  REQUIRE(resource.deallocated == 1);
+  std::pmr::set_default_resource(previous);
+}
@@ -0,0 +1,176 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <system_error>
+
+#include "alloc_counter.hpp"
+#include "rd/error_chain.hpp"
+#include "test_include.hpp"
+
+namespace {
+using chain = rd::error_chain<std::errc>;
+
+auto open_file(int fd) -> rd::expected<int, chain> {
+  if (fd < 0) {
+    return rd::unexpected(std::errc::bad_file_descriptor);
+  }
+  return fd;
+}
+
+auto read_config(int fd) -> rd::expected<int, chain> {
+  return open_file(fd).context("while reading the config");
+}
+
+auto start(int fd) -> rd::expected<void, chain> {
+  auto config = read_config(fd).context("while starting");
+  if (!config) {
+    return rd::unexpected(std::move(config).error());
+  }
+  return {};
+}
+
+// Forwards to new and delete and counts the bytes in use.
+class buffer_resource : public std::pmr::memory_resource {
+ public:
+  std::size_t in_use = 0;  // NOLINT
+
+ private:
+  auto do_allocate(std::size_t bytes, std::size_t align) -> void* override {
+    in_use += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    in_use -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  [[nodiscard]] auto do_is_equal(memory_resource const& other) const noexcept
+      -> bool override {
+    return this == &other;
+  }
+};
+}  // namespace
+
+static_assert(std::is_nothrow_move_constructible_v<chain>);
+static_assert(rd::is_trivially_relocatable<chain>::value);
+
+TEST_CASE("error_chain: static context frames don't allocate") {
+  alloc_counter::scope scope;
+  auto ok = start(1);
+  auto e = start(-1);
+  REQUIRE(ok.has_value());
+  REQUIRE(!e.has_value());
+  REQUIRE(scope.count() == 0);
+  REQUIRE(e.error().size() == 2);
+  REQUIRE(e.error().context(0) == "while starting");
+  REQUIRE(e.error().context(1) == "while reading the config");
+  REQUIRE(e.error().error() == std::errc::bad_file_descriptor);
+}
+
+TEST_CASE("error_chain: rendering") {
+  auto e = start(-1);
+  auto const cause =
+      std::make_error_code(std::errc::bad_file_descriptor).message();
+  REQUIRE(e.error().message() ==
+          "while starting: while reading the config: " + cause);
+  REQUIRE(chain(std::errc::io_error).message() ==
+          std::make_error_code(std::errc::io_error).message());
+}
+
+TEST_CASE("error_chain: context is only added to errors") {
+  rd::expected<int, chain> x = 1;
+  x.context("unused");
+  REQUIRE(*x == 1);
+
+  bool called = false;
+  x.with_context([&] {
+    called = true;
+    return std::string("unused");
+  });
+  REQUIRE(!called);
+
+  rd::expected<int, chain> y = rd::unexpected(std::errc::io_error);
+  y.with_context([&] {
+    called = true;
+    return std::to_string(42);
+  });
+  REQUIRE(called);
+  REQUIRE(y.error().context(0) == "42");
+}
+
+TEST_CASE("error_chain: the ring keeps the most recent frames") {
+  rd::error_chain<std::string, 2> e("cause");
+  e.add_context(rd::static_context("a"));
+  e.add_context(std::string("b"));
+  e.add_context(rd::static_context("c"));
+  REQUIRE(e.size() == 2);
+  REQUIRE(e.dropped() == 1);
+  REQUIRE(e.message() == "c: b: ...: cause");
+  e.add_context(std::string("d"));
+  REQUIRE(e.message() == "d: c: ...: cause");
+}
+
+TEST_CASE("error_chain: dynamic frames use the error arena") {
+  buffer_resource resource;
+  {
+    rd::error_arena arena(&resource);
+    chain e(std::errc::io_error);
+    e.add_context(std::string("frame"));
+    REQUIRE(resource.in_use != 0);
+
+    auto copy = e;
+    REQUIRE(copy.context(0) == "frame");
+    REQUIRE(copy.context(0).data() != e.context(0).data());
+
+    auto moved = std::move(e);
+    REQUIRE(moved.context(0) == "frame");
+    REQUIRE(e.size() == 0);  // NOLINT
+
+    copy = moved;
+    REQUIRE(copy.context(0) == "frame");
+  }
+  REQUIRE(resource.in_use == 0);
+}
+
+TEST_CASE("error_chain: dynamic frames keep embedded NULs") {
+  using namespace std::string_literals;
+  buffer_resource resource;
+  {
+    rd::error_arena arena(&resource);
+    chain e(std::errc::io_error);
+    e.add_context("key\0value"s);
+    REQUIRE(e.context(0) == "key\0value"s);
+
+    auto copy = e;
+    REQUIRE(copy.context(0) == "key\0value"s);
+    copy.add_context(rd::static_context("outer"));
+    REQUIRE(copy.message().starts_with("outer: key\0value: "s));
+  }
+  REQUIRE(resource.in_use == 0);
+}
@@ -86,6 +86,15 @@ TEST_CASE("or_else && returns void with error") {
   REQUIRE(e.error() == "error");
 }
 
+TEST_CASE("or_else && returns void keeps the error for a by-value handler") {
+  rd::expected<int, std::string> ex{rd::unexpect, "error"};
+  std::string seen;
+  auto e = std::move(ex).or_else([&](std::string s) { seen = s; });
+  REQUIRE(seen == "error");
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == "error");
+}
+
 TEST_CASE("or_else & returns void with value") {
   rd::expected<std::string, std::string> ex{"value"};
   auto e = ex.or_else([](auto) {});
@@ -128,6 +137,28 @@ TEST_CASE("or_else void && returns void with error") {
   REQUIRE(e.error() == "error");
 }
 
+TEST_CASE("or_else void && returns void keeps the error for a by-value "
+          "handler") {
+  rd::expected<void, std::string> ex{rd::unexpect, "error"};
+  std::string seen;
+  auto e = std::move(ex).or_else([&](std::string s) { seen = s; });
+  REQUIRE(seen == "error");
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == "error");
+}
+
+// A void handler gets the error as an lvalue, so one taking only an rvalue
+// isn't accepted.
+namespace {
+template <class Ex>
+concept or_else_with_rvalue_handler = requires(Ex ex) {
+  std::move(ex).or_else([](std::string&&) {});
+};
+}  // namespace
+
+static_assert(!or_else_with_rvalue_handler<rd::expected<int, std::string>>);
+static_assert(!or_else_with_rvalue_handler<rd::expected<void, std::string>>);
+
 TEST_CASE("or_else void & returns void with value") {
   rd::expected<void, std::string> ex{};
   auto e = ex.or_else([](auto) {});
@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "alloc_counter.hpp"
+#include "test_include.hpp"
+
+namespace {
+using alloc_counter::long_string;
+
+struct my_error {
+  my_error(std::string const& m) : msg(m) {}             // NOLINT
+  my_error(std::string&& m) noexcept : msg(std::move(m)) {}  // NOLINT
+
+  std::string msg;
+};
+}  // namespace
+
+TEST_CASE("allocation: converting rvalue with value moves") {
+  rd::expected<std::string, std::string> src{long_string('v')};
+  alloc_counter::scope scope;
+  rd::expected<std::string, my_error> dst{std::move(src)};
+  REQUIRE(scope.count() == 0);
+  REQUIRE(*dst == long_string('v'));
+}
+
+TEST_CASE("allocation: converting rvalue with error moves") {
+  rd::expected<std::string, std::string> src{rd::unexpect, long_string('e')};
+  alloc_counter::scope scope;
+  rd::expected<std::string, my_error> dst{std::move(src)};
+  REQUIRE(scope.count() == 0);
+  REQUIRE(dst.error().msg == long_string('e'));
+}
+
+TEST_CASE("allocation: converting lvalue copies") {
+  rd::expected<std::string, std::string> src{rd::unexpect, long_string('e')};
+  alloc_counter::scope scope;
+  rd::expected<std::string, my_error> dst{src};
+  REQUIRE(scope.count() == 1);
+  REQUIRE(src.error() == long_string('e'));
+}
+
+TEST_CASE("allocation: converting void rvalue with error moves") {
+  rd::expected<void, std::string> src{rd::unexpect, long_string('e')};
+  alloc_counter::scope scope;
+  rd::expected<void, my_error> dst{std::move(src)};
+  REQUIRE(scope.count() == 0);
+  REQUIRE(dst.error().msg == long_string('e'));
+}
+
+TEST_CASE("allocation: move assignment moves") {
+  rd::expected<std::string, std::string> val{long_string('v')};
+  rd::expected<std::string, std::string> err{rd::unexpect, long_string('e')};
+  rd::expected<std::string, std::string> dst{long_string('d')};
+  alloc_counter::scope scope;
+  dst = std::move(err);
+  dst = std::move(val);
+  dst = rd::unexpected(long_string('u'));
+  REQUIRE(scope.count() == 1);
+  REQUIRE(dst.error() == long_string('u'));
+}
+
+TEST_CASE("allocation: value and unexpected assignment move") {
+  auto value = long_string('v');
+  auto error = rd::unexpected(long_string('e'));
+  rd::expected<std::string, std::string> dst{rd::unexpect, long_string('d')};
+  alloc_counter::scope scope;
+  dst = std::move(value);
+  dst = std::move(error);
+  REQUIRE(scope.count() == 0);
+  REQUIRE(dst.error() == long_string('e'));
+}
+
+TEST_CASE("allocation: rvalue monadic operations move") {
+  rd::expected<std::string, std::string> val{long_string('v')};
+  rd::expected<std::string, std::string> err{rd::unexpect, long_string('e')};
+  auto identity = [](std::string s) { return s; };
+  auto to_expected = [](std::string s) {
+    return rd::expected<std::string, std::string>(std::move(s));
+  };
+  auto to_unexpected = [](std::string s) {
+    return rd::expected<std::string, std::string>(rd::unexpect, std::move(s));
+  };
+  alloc_counter::scope scope;
+  auto a = std::move(val).transform(identity);
+  auto b = std::move(a).and_then(to_expected);
+  auto c = std::move(b).or_else(to_unexpected);
+  auto d = std::move(c).transform_error(identity);
+  auto e = std::move(err).transform(identity);
+  auto f = std::move(e).and_then(to_expected);
+  auto g = std::move(f).or_else(to_unexpected);
+  auto h = std::move(g).transform_error(identity);
+  REQUIRE(scope.count() == 0);
+  REQUIRE(*d == long_string('v'));
+  REQUIRE(h.error() == long_string('e'));
+}
+
+TEST_CASE("allocation: lvalue transform with void result doesn't move") {
+  rd::expected<std::string, int> val{long_string('v')};
+  std::string seen;
+  (void)val.transform([&](std::string s) { seen = std::move(s); });
+  REQUIRE(*val == long_string('v'));
+  REQUIRE(seen == long_string('v'));
+}
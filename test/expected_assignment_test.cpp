@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include "alloc_counter.hpp"
 #include "test_include.hpp"
 
 TEST_CASE("copy: lhs has value, rhs has error") {
@@ -189,3 +190,40 @@ TEST_CASE("assigning unexpected : lhs has error with conversion COPY") {
   REQUIRE(!lhs.has_value());
   REQUIRE(lhs.error() == "2");
 }
+
+TEST_CASE("move assignment doesn't allocate in any state") {
+  using result = rd::expected<std::string, std::string>;
+  auto const v = alloc_counter::long_string('v');
+  auto const e = alloc_counter::long_string('e');
+  result value_to_value{v};
+  result error_to_value{rd::unexpect, e};
+  result value_to_error{v};
+  result error_to_error{rd::unexpect, e};
+  result values[] = {result{v}, result{v}};
+  result errors[] = {result{rd::unexpect, e}, result{rd::unexpect, e}};
+  REQUIRE_NO_ALLOC {
+    value_to_value = std::move(values[0]);
+    error_to_value = std::move(values[1]);
+    value_to_error = std::move(errors[0]);
+    error_to_error = std::move(errors[1]);
+  }
+  REQUIRE(*value_to_value == v);
+  REQUIRE(*error_to_value == v);
+  REQUIRE(value_to_error.error() == e);
+  REQUIRE(error_to_error.error() == e);
+}
+
+TEST_CASE("rvalue value and unexpected assignment doesn't allocate") {
+  using result = rd::expected<std::string, std::string>;
+  auto v = alloc_counter::long_string('v');
+  auto e = rd::unexpected(alloc_counter::long_string('e'));
+  result lhs{rd::unexpect, "error"};
+  std::string value;
+  REQUIRE_NO_ALLOC {
+    lhs = std::move(v);
+    value = std::move(*lhs);
+    lhs = std::move(e);
+  }
+  REQUIRE(value == alloc_counter::long_string('v'));
+  REQUIRE(lhs.error() == alloc_counter::long_string('e'));
+}
@@ -24,6 +24,7 @@
 
 #include <vector>
 
+#include "alloc_counter.hpp"
 #include "test_include.hpp"
 
 TEST_CASE("default constructor") {
@@ -190,6 +191,26 @@ TEST_CASE("expected conversion-move-constructor with error") {
   REQUIRE(ex.error() == "2");
 }
 
+namespace {
+struct from_anything {
+  template <class U>
+  from_anything(U&& /*unused*/) {}  // NOLINT
+};
+}  // namespace
+
+TEST_CASE("expected of a type constructible from expected holds it as value") {
+  rd::expected<int, int> const orig(rd::unexpect, 2);
+  rd::expected<from_anything, int> ex(orig);
+  REQUIRE(ex.has_value());
+}
+
+TEST_CASE("expected<bool> holds an expected converted to bool as value") {
+  rd::expected<int, int> const orig(rd::unexpect, 2);
+  rd::expected<bool, int> ex(orig);
+  REQUIRE(ex.has_value());
+  REQUIRE(!*ex);
+}
+
 TEST_CASE("value constructor test with no conversion with value") {
   rd::expected<int_to_str, int_to_str> ex(int_to_str(2));
   REQUIRE(ex.has_value());
@@ -253,3 +274,32 @@ TEST_CASE("unexpect constructor with initializer list") {
   REQUIRE(!ex.has_value());
   REQUIRE(ex.error() == std::vector<int>({2, 2}));
 }
+
+TEST_CASE("constructing from rvalues doesn't allocate") {
+  using result = rd::expected<std::string, std::string>;
+  auto const v = alloc_counter::long_string('v');
+  auto const e = alloc_counter::long_string('e');
+  auto value = v;
+  auto error = e;
+  auto u = rd::unexpected(e);
+  result val{v};
+  result err{rd::unexpect, e};
+  std::string posts[5];
+  REQUIRE_NO_ALLOC {
+    result from_value{std::move(value)};
+    result from_error{rd::unexpect, std::move(error)};
+    result from_unexpected{std::move(u)};
+    result moved_value{std::move(val)};
+    result moved_error{std::move(err)};
+    posts[0] = std::move(*from_value);
+    posts[1] = std::move(from_error.error());
+    posts[2] = std::move(from_unexpected.error());
+    posts[3] = std::move(*moved_value);
+    posts[4] = std::move(moved_error.error());
+  }
+  REQUIRE(posts[0] == v);
+  REQUIRE(posts[1] == e);
+  REQUIRE(posts[2] == e);
+  REQUIRE(posts[3] == v);
+  REQUIRE(posts[4] == e);
+}
@@ -0,0 +1,169 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <utility>
+
+#include "alloc_counter.hpp"
+#include "test_include.hpp"
+
+namespace {
+// Counts the moves and copies made of it.
+struct tracked {
+  int value = 0;
+  int* copies_and_moves;
+
+  tracked(int v, int* count) : value(v), copies_and_moves(count) {}
+  tracked(tracked const& other)
+      : value(other.value), copies_and_moves(other.copies_and_moves) {
+    ++*copies_and_moves;
+  }
+  tracked(tracked&& other) noexcept
+      : value(other.value), copies_and_moves(other.copies_and_moves) {
+    ++*copies_and_moves;
+  }
+  auto operator=(tracked const&) -> tracked& = default;
+  auto operator=(tracked&&) noexcept -> tracked& = default;
+  ~tracked() = default;
+};
+
+auto fail_if_odd(int& x) -> rd::expected<void, std::string> {
+  if (x % 2 != 0) {
+    return rd::unexpected(std::string("odd"));
+  }
+  x /= 2;
+  return {};
+}
+}  // namespace
+
+TEST_CASE("transform_inplace & with value") {
+  rd::expected<int, std::string> e{2};
+  auto& r = e.transform_inplace([](int& x) { x += 3; });
+  REQUIRE(&r == &e);
+  REQUIRE(*e == 5);
+}
+
+TEST_CASE("transform_inplace & with error") {
+  rd::expected<int, std::string> e{rd::unexpect, "error"};
+  bool called = false;
+  e.transform_inplace([&](int& /*unused*/) { called = true; });
+  REQUIRE(!called);
+  REQUIRE(e.error() == "error");
+}
+
+TEST_CASE("transform_inplace && chain doesn't move the value") {
+  int count = 0;
+  rd::expected<tracked, int> e{std::in_place, 1, &count};
+  auto&& r = std::move(e)
+                 .transform_inplace([](tracked& t) { t.value *= 10; })
+                 .transform_inplace([](tracked& t) { t.value += 1; });
+  REQUIRE(&r == &e);
+  REQUIRE(e->value == 11);
+  REQUIRE(count == 0);
+}
+
+TEST_CASE("transform_error_inplace & with error") {
+  rd::expected<int, std::string> e{rd::unexpect, "error"};
+  e.transform_error_inplace([](std::string& s) { s += "!"; });
+  REQUIRE(e.error() == "error!");
+}
+
+TEST_CASE("transform_error_inplace & with value") {
+  rd::expected<int, std::string> e{1};
+  bool called = false;
+  e.transform_error_inplace([&](std::string& /*unused*/) { called = true; });
+  REQUIRE(!called);
+  REQUIRE(*e == 1);
+}
+
+TEST_CASE("and_then_inplace & with value, with success continuation") {
+  rd::expected<int, std::string> e{8};
+  e.and_then_inplace(fail_if_odd).and_then_inplace(fail_if_odd);
+  REQUIRE(*e == 2);
+}
+
+TEST_CASE("and_then_inplace & with value, with failed continuation") {
+  rd::expected<int, std::string> e{6};
+  e.and_then_inplace(fail_if_odd).and_then_inplace(fail_if_odd);
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == "odd");
+}
+
+TEST_CASE("and_then_inplace & with error") {
+  rd::expected<int, std::string> e{rd::unexpect, "error"};
+  e.and_then_inplace(fail_if_odd);
+  REQUIRE(e.error() == "error");
+}
+
+TEST_CASE("and_then_inplace && returns the result by value") {
+  auto r = rd::expected<int, std::string>{4}
+               .and_then_inplace(fail_if_odd)
+               .transform_inplace([](int& x) { x += 1; });
+  REQUIRE(*r == 3);
+}
+
+TEST_CASE("inplace members are usable in constant expressions") {
+  constexpr auto r = [] {
+    rd::expected<int, int> e{3};
+    e.transform_inplace([](int& x) { x *= 2; })
+        .and_then_inplace([](int& x) -> rd::expected<void, int> {
+          return rd::unexpected(x);
+        })
+        .transform_error_inplace([](int& x) { x += 1; });
+    return e;
+  }();
+  static_assert(!r.has_value() && r.error() == 7);
+}
+
+TEST_CASE("void transform_error_inplace and and_then_inplace") {
+  rd::expected<void, std::string> e;
+  e.transform_error_inplace([](std::string& s) { s += "!"; });
+  REQUIRE(e.has_value());
+  e.and_then_inplace([]() -> rd::expected<void, std::string> {
+     return rd::unexpected(std::string("error"));
+   }).transform_error_inplace([](std::string& s) { s += "!"; });
+  REQUIRE(e.error() == "error!");
+}
+
+TEST_CASE("reference transform_error_inplace") {
+  int x = 1;
+  rd::expected<int&, std::string> e{x};
+  e.transform_error_inplace([](std::string& s) { s += "!"; });
+  REQUIRE(&*e == &x);
+  rd::expected<int&, std::string> f{rd::unexpect, "error"};
+  f.transform_error_inplace([](std::string& s) { s += "!"; });
+  REQUIRE(f.error() == "error!");
+}
+
+TEST_CASE("inplace members don't allocate") {
+  rd::expected<std::string, std::string> e{alloc_counter::long_string('a')};
+  REQUIRE_NO_ALLOC {
+    e.transform_inplace([](std::string& s) { s[0] = 'b'; })
+        .and_then_inplace([](std::string& s) -> rd::expected<void, std::string> {
+          s[1] = 'c';
+          return {};
+        });
+  }
+  REQUIRE(e->substr(0, 3) == "bca");
+}
@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <utility>
+
+#include "alloc_counter.hpp"
+#include "test_include.hpp"
+
+TEST_CASE("inspect & with value") {
+  rd::expected<int, std::string> e{2};
+  int seen = 0;
+  auto& r = e.inspect([&](int const& x) { seen = x; });
+  REQUIRE(&r == &e);
+  REQUIRE(seen == 2);
+}
+
+TEST_CASE("inspect & with error") {
+  rd::expected<int, std::string> e{rd::unexpect, "error"};
+  bool called = false;
+  e.inspect([&](int const& /*unused*/) { called = true; });
+  REQUIRE(!called);
+}
+
+TEST_CASE("inspect_error const& with error") {
+  rd::expected<int, std::string> const e{rd::unexpect, "error"};
+  std::string seen;
+  auto const& r = e.inspect_error([&](std::string const& s) { seen = s; });
+  REQUIRE(&r == &e);
+  REQUIRE(seen == "error");
+}
+
+TEST_CASE("inspect_error & with value") {
+  rd::expected<int, std::string> e{1};
+  bool called = false;
+  e.inspect_error([&](std::string const& /*unused*/) { called = true; });
+  REQUIRE(!called);
+}
+
+TEST_CASE("inspect && forwards the expected without copying it") {
+  rd::expected<std::string, std::string> e{rd::unexpect,
+                                           alloc_counter::long_string('a')};
+  std::size_t seen = 0;
+  REQUIRE_NO_ALLOC {
+    auto&& r = std::move(e)
+                   .inspect([&](std::string const& /*unused*/) { seen = 1; })
+                   .inspect_error([&](std::string const& s) { seen = s.size(); });
+    REQUIRE(&r == &e);
+  }
+  REQUIRE(seen == 64);
+  REQUIRE(e.error().size() == 64);
+}
+
+TEST_CASE("inspect in a chain of members") {
+  int logged = 0;
+  auto r = rd::expected<int, int>{rd::unexpect, 3}
+               .inspect_error([&](int const& x) { logged = x; })
+               .transform([](int x) { return x + 1; });
+  REQUIRE(logged == 3);
+  REQUIRE(r.error() == 3);
+}
+
+TEST_CASE("inspect const&& with value") {
+  rd::expected<int, int> const e{5};
+  int seen = 0;
+  std::move(e).inspect([&](int const& x) { seen = x; });  // NOLINT
+  REQUIRE(seen == 5);
+}
+
+TEST_CASE("void inspect and inspect_error") {
+  rd::expected<void, int> e;
+  bool called = false;
+  e.inspect([&] { called = true; }).inspect_error([&](int const&) {
+    called = false;
+  });
+  REQUIRE(called);
+  rd::expected<void, int> f{rd::unexpect, 4};
+  int seen = 0;
+  std::move(f).inspect([&] { seen = -1; }).inspect_error([&](int const& x) {
+    seen = x;
+  });
+  REQUIRE(seen == 4);
+}
+
+TEST_CASE("reference inspect and inspect_error") {
+  int x = 6;
+  rd::expected<int&, int> e{x};
+  int const* seen = nullptr;
+  e.inspect([&](int const& v) { seen = &v; });
+  REQUIRE(seen == &x);
+  rd::expected<int&, int> f{rd::unexpect, 2};
+  int error = 0;
+  f.inspect_error([&](int const& v) { error = v; });
+  REQUIRE(error == 2);
+}
+
+TEST_CASE("inspect is usable in constant expressions") {
+  constexpr auto r = [] {
+    int seen = 0;
+    rd::expected<int, int>{4}.inspect([&](int const& v) { seen = v; });
+    return seen;
+  }();
+  static_assert(r == 4);
+}
+
+TEST_CASE("or_else const&& with void continuation") {
+  rd::expected<int, int> const value{1};
+  bool called = false;
+  auto r = std::move(value).or_else([&](int const& /*unused*/) {  // NOLINT
+    called = true;
+  });
+  REQUIRE(!called);
+  REQUIRE(*r == 1);
+  rd::expected<int, int> const error{rd::unexpect, 2};
+  int seen = 0;
+  auto s = std::move(error).or_else([&](int const& x) { seen = x; });  // NOLINT
+  REQUIRE(seen == 2);
+  REQUIRE(s.error() == 2);
+}
+
+TEST_CASE("void or_else const&& with void continuation") {
+  rd::expected<void, int> const value;
+  bool called = false;
+  auto r = std::move(value).or_else([&](int const& /*unused*/) {  // NOLINT
+    called = true;
+  });
+  REQUIRE(!called);
+  REQUIRE(r.has_value());
+  rd::expected<void, int> const error{rd::unexpect, 2};
+  int seen = 0;
+  auto s = std::move(error).or_else([&](int const& x) { seen = x; });  // NOLINT
+  REQUIRE(seen == 2);
+  REQUIRE(s.error() == 2);
+}
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <system_error>
+
+#include "test_include.hpp"
+
+namespace {
+// Checks everything the Itanium ABI needs to pass a class in registers, plus
+// trivial assignment.
+template <class T>
+constexpr bool trivial =
+    std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T> &&
+    std::is_trivially_copy_constructible_v<T> &&
+    std::is_trivially_move_constructible_v<T> &&
+    std::is_trivially_copy_assignable_v<T> &&
+    std::is_trivially_move_assignable_v<T>;
+
+struct non_trivial_dtor {
+  ~non_trivial_dtor() {}  // NOLINT
+};
+}  // namespace
+
+static_assert(trivial<rd::expected<int, int>>);
+static_assert(trivial<rd::expected<int, std::errc>>);
+static_assert(trivial<rd::expected<double, char>>);
+static_assert(trivial<rd::expected<int*, std::errc>>);
+static_assert(trivial<rd::expected<void, int>>);
+static_assert(trivial<rd::expected<void, std::errc>>);
+
+static_assert(!trivial<rd::expected<std::string, int>>);
+static_assert(!trivial<rd::expected<int, std::string>>);
+static_assert(!trivial<rd::expected<void, std::string>>);
+static_assert(!std::is_trivially_destructible_v<
+              rd::expected<non_trivial_dtor, int>>);
+static_assert(!std::is_trivially_destructible_v<
+              rd::expected<void, non_trivial_dtor>>);
+
+static_assert(sizeof(rd::expected<int, int>) == 2 * sizeof(int));
+static_assert(sizeof(rd::expected<void, int>) == 2 * sizeof(int));
+
+TEST_CASE("layout: trivial copy keeps the state") {
+  rd::expected<int, int> val{3};
+  rd::expected<int, int> err{rd::unexpect, 4};
+  auto val_copy = val;
+  auto err_copy = err;
+  REQUIRE(val_copy.has_value());
+  REQUIRE(*val_copy == 3);
+  REQUIRE(!err_copy.has_value());
+  REQUIRE(err_copy.error() == 4);
+  val_copy = err;
+  REQUIRE(!val_copy.has_value());
+  REQUIRE(val_copy.error() == 4);
+}
+
+TEST_CASE("layout: trivial void copy keeps the state") {
+  rd::expected<void, int> val{};
+  rd::expected<void, int> err{rd::unexpect, 4};
+  auto copy = val;
+  REQUIRE(copy.has_value());
+  copy = err;
+  REQUIRE(!copy.has_value());
+  REQUIRE(copy.error() == 4);
+}
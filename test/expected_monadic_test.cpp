@@ -22,24 +22,30 @@
  * SOFTWARE.
  */
 
+#include <charconv>
+#include <functional>
 #include <string>
+#include <system_error>
 
+#include "alloc_counter.hpp"
 #include "test_include.hpp"
 
 auto to_int(std::string const& str) -> rd::expected<int, std::string> {
-  try {
-    return std::stoi(str);
-  } catch (...) {
+  int x = 0;
+  if (std::from_chars(str.data(), str.data() + str.size(), x).ec !=
+      std::errc{}) {
     return rd::unexpected{"error"};
   }
+  return x;
 }
 
 auto error_to_int(std::string const& str) -> rd::expected<std::string, int> {
-  try {
-    return rd::unexpected{std::stoi(str)};
-  } catch (...) {
+  int x = 0;
+  if (std::from_chars(str.data(), str.data() + str.size(), x).ec !=
+      std::errc{}) {
     return "0";
   }
+  return rd::unexpected{x};
 }
 
 auto add_1(int x) { return x + 1; }
@@ -258,6 +264,39 @@ TEST_CASE("transform && with error") {
   REQUIRE(post.error() == 2);
 }
 
+namespace {
+struct point {
+  int x;
+  [[nodiscard]] auto twice() const -> int { return 2 * x; }
+  [[nodiscard]] auto checked() const -> rd::expected<int, int> {
+    if (x < 0) {
+      return rd::unexpected(x);
+    }
+    return x;
+  }
+};
+}  // namespace
+
+TEST_CASE("monadic operations with pointers to members") {
+  rd::expected<point, int> pre{point{2}};
+  REQUIRE(*pre.transform(&point::x) == 2);
+  REQUIRE(*pre.transform(&point::twice) == 4);
+  REQUIRE(*std::move(pre).and_then(&point::checked) == 2);
+  rd::expected<point, int> negative{point{-1}};
+  REQUIRE(negative.and_then(&point::checked).error() == -1);
+}
+
+TEST_CASE("monadic operations with pointers to members through a pointer") {
+  point p{3};
+  rd::expected<point*, int> ptr{&p};
+  REQUIRE(*ptr.transform(&point::x) == 3);
+  REQUIRE(*ptr.transform(&point::twice) == 6);
+  rd::expected<std::reference_wrapper<point>, int> ref{std::ref(p)};
+  REQUIRE(*ref.transform(&point::twice) == 6);
+  ref->get().x = 4;
+  REQUIRE(*ptr.transform(&point::x) == 4);
+}
+
 TEST_CASE("transform_error & with value") {
   rd::expected<int, int> pre{2};
   auto post = pre.transform_error(add_1);
@@ -299,3 +338,72 @@ TEST_CASE("transform_error && with error") {
   REQUIRE(!post.has_value());
   REQUIRE(post.error() == 3);
 }
+
+namespace {
+struct move_only {
+  explicit move_only(std::string s) : text(std::move(s)) {}
+  move_only(move_only&&) noexcept = default;
+  move_only(move_only const&) = delete;
+  auto operator=(move_only&&) noexcept -> move_only& = default;
+  auto operator=(move_only const&) -> move_only& = delete;
+  ~move_only() = default;
+
+  std::string text;
+};
+}  // namespace
+
+TEST_CASE("rvalue monadic chains don't allocate") {
+  using result = rd::expected<std::string, std::string>;
+  auto const v = alloc_counter::long_string('v');
+  auto const e = alloc_counter::long_string('e');
+  result val{v};
+  result err{rd::unexpect, e};
+  auto identity = [](std::string s) { return s; };
+  auto succeed = [](std::string s) { return result(std::move(s)); };
+  auto fail = [](std::string s) { return result(rd::unexpect, std::move(s)); };
+  result val_post;
+  result err_post;
+  REQUIRE_NO_ALLOC {
+    val_post = std::move(val)
+                   .and_then(succeed)
+                   .transform(identity)
+                   .or_else(fail)
+                   .transform_error(identity);
+    err_post = std::move(err)
+                   .and_then(succeed)
+                   .transform(identity)
+                   .or_else(fail)
+                   .transform_error(identity);
+  }
+  REQUIRE(*val_post == v);
+  REQUIRE(err_post.error() == e);
+}
+
+TEST_CASE("monadic chains on move-only types don't allocate") {
+  using result = rd::expected<move_only, move_only>;
+  auto const v = alloc_counter::long_string('v');
+  auto const e = alloc_counter::long_string('e');
+  result val{std::in_place, v};
+  result err{rd::unexpect, e};
+  auto identity = [](move_only m) { return m; };
+  auto fail = [](move_only m) { return result(rd::unexpect, std::move(m)); };
+  std::string val_post;
+  std::string err_post;
+  REQUIRE_NO_ALLOC {
+    val_post = std::move(val)
+                   .transform(identity)
+                   .or_else(fail)
+                   .transform_error(identity)
+                   .value()
+                   .text;
+    err_post = std::move(err)
+                   .transform(identity)
+                   .and_then(
+                       [](move_only m) { return result(std::move(m)); })
+                   .transform_error(identity)
+                   .error()
+                   .text;
+  }
+  REQUIRE(val_post == v);
+  REQUIRE(err_post == e);
+}
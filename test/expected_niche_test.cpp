@@ -0,0 +1,238 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <memory>
+#include <system_error>
+
+#include "test_include.hpp"
+
+namespace {
+enum class small_enum : unsigned char { first, second };
+
+enum class spare_enum : unsigned { zero, one, two };
+
+struct aligned_error {
+  int code;
+  int line;
+};
+
+struct declared_only;
+
+struct node {
+  node* next;
+  int value;
+};
+}  // namespace
+
+template <>
+struct rd::niche_traits<spare_enum> : rd::enum_niche<spare_enum> {};
+
+template <>
+struct rd::niche_traits<node*> : rd::pointer_niche<node> {};
+
+// Without a way to tell which member is alive during constant evaluation,
+// expected keeps the flag.
+constexpr bool niches = rd::detail::niche_supported;
+
+static_assert(!niches ||
+              sizeof(rd::expected<int*, small_enum>) == sizeof(int*));
+static_assert(!niches ||
+              sizeof(rd::expected<int*, std::errc>) == sizeof(int*));
+static_assert(!niches ||
+              sizeof(rd::expected<std::unique_ptr<int>, std::errc>) ==
+                  sizeof(int*));
+static_assert(!niches ||
+              sizeof(rd::expected<int&, small_enum>) == sizeof(int*));
+static_assert(!niches ||
+              sizeof(rd::expected<spare_enum, small_enum>) ==
+                  sizeof(spare_enum));
+
+static_assert(!niches ||
+              sizeof(rd::expected<node*, small_enum>) == sizeof(node*));
+
+// The niche of the error holds the state when the value ends before it.
+static_assert(!niches ||
+              sizeof(rd::expected<small_enum, spare_enum>) ==
+                  sizeof(spare_enum));
+static_assert(!niches ||
+              sizeof(rd::expected<void, spare_enum>) == sizeof(spare_enum));
+
+// No niche to use: char is not aligned enough to free a bit, or the error
+// doesn't fit beside the niche byte.
+static_assert(sizeof(rd::expected<char*, small_enum>) > sizeof(char*));
+static_assert(sizeof(rd::expected<int*, aligned_error>) > sizeof(int*));
+static_assert(sizeof(rd::expected<int*, std::string>) > sizeof(std::string));
+
+// Pointers to classes that don't opt in keep the flag, whether or not the
+// class is complete, so the layout is the same in every translation unit.
+static_assert(sizeof(rd::expected<declared_only*, small_enum>) >
+              sizeof(declared_only*));
+static_assert(sizeof(rd::expected<aligned_error*, small_enum>) >
+              sizeof(aligned_error*));
+
+// The state of a niche-optimized expected is known in constant expressions
+// too.
+static_assert([] {
+  int x = 1;
+  rd::expected<int*, small_enum> e{&x};
+  bool ok = e.has_value() && *e == &x;
+  e = rd::unexpected(small_enum::second);
+  ok = ok && !e.has_value() && e.error() == small_enum::second;
+  e = nullptr;
+  return ok && e.has_value() && *e == nullptr;
+}());
+static_assert([] {
+  rd::expected<spare_enum, small_enum> e{spare_enum::two};
+  bool ok = e.has_value() && *e == spare_enum::two;
+  e = rd::unexpected(small_enum::first);
+  return ok && !e.has_value() && e.error() == small_enum::first;
+}());
+
+static_assert([] {
+  int x = 1;
+  rd::expected<void, int*> e;
+  bool ok = e.has_value();
+  e = rd::unexpected(&x);
+  ok = ok && !e.has_value() && e.error() == &x;
+  rd::expected<void, int*> copy = e;
+  e.emplace();
+  return ok && e.has_value() && !copy.has_value() && copy.error() == &x;
+}());
+static_assert([] {
+  rd::expected<small_enum, spare_enum> e{small_enum::second};
+  bool ok = e.has_value() && *e == small_enum::second;
+  rd::expected<small_enum, spare_enum> other{rd::unexpect, spare_enum::two};
+  swap(e, other);
+  ok = ok && !e.has_value() && e.error() == spare_enum::two;
+  return ok && other.has_value() && *other == small_enum::second;
+}());
+
+constexpr rd::expected<int*, std::errc> constant_error{
+    rd::unexpect, std::errc::invalid_argument};
+constexpr rd::expected<spare_enum, small_enum> constant_value{spare_enum::one};
+constexpr rd::expected<small_enum, spare_enum> constant_error_niche{
+    small_enum::second};
+constexpr rd::expected<void, spare_enum> constant_void{};
+static_assert(!constant_error.has_value());
+static_assert(constant_value.has_value());
+static_assert(constant_error_niche.has_value());
+static_assert(constant_void.has_value());
+
+TEST_CASE("niche: constant initialized") {
+  REQUIRE(!constant_error.has_value());
+  REQUIRE(constant_error.error() == std::errc::invalid_argument);
+  REQUIRE(constant_value.has_value());
+  REQUIRE(*constant_value == spare_enum::one);
+  REQUIRE(constant_error_niche.has_value());
+  REQUIRE(*constant_error_niche == small_enum::second);
+  REQUIRE(constant_void.has_value());
+}
+
+TEST_CASE("niche: pointer value and error") {
+  int x = 1;
+  rd::expected<int*, small_enum> val{&x};
+  rd::expected<int*, small_enum> null{nullptr};
+  rd::expected<int*, small_enum> err{rd::unexpect, small_enum::second};
+  REQUIRE(val.has_value());
+  REQUIRE(*val == &x);
+  REQUIRE(null.has_value());
+  REQUIRE(*null == nullptr);
+  REQUIRE(!err.has_value());
+  REQUIRE(err.error() == small_enum::second);
+}
+
+TEST_CASE("niche: pointer state transitions") {
+  int x = 1;
+  rd::expected<int*, std::errc> e{&x};
+  e = rd::unexpected(std::errc::invalid_argument);
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == std::errc::invalid_argument);
+  e.error() = std::errc::io_error;
+  REQUIRE(e.error() == std::errc::io_error);
+  e = nullptr;
+  REQUIRE(e.has_value());
+  REQUIRE(*e == nullptr);
+  rd::expected<int*, std::errc> other{rd::unexpect, std::errc::timed_out};
+  swap(e, other);
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == std::errc::timed_out);
+  REQUIRE(other.has_value());
+  e.emplace(&x);
+  REQUIRE(e.value() == &x);
+}
+
+TEST_CASE("niche: unique_ptr keeps ownership semantics") {
+  rd::expected<std::unique_ptr<int>, std::errc> e{std::make_unique<int>(3)};
+  REQUIRE(e.has_value());
+  REQUIRE(**e == 3);
+  auto moved = std::move(e);
+  REQUIRE(moved.has_value());
+  REQUIRE(**moved == 3);
+  moved = rd::unexpected(std::errc::no_buffer_space);
+  REQUIRE(!moved.has_value());
+  REQUIRE(moved.error() == std::errc::no_buffer_space);
+  auto r = std::move(moved).transform([](auto&& p) { return *p; });
+  REQUIRE(r.error() == std::errc::no_buffer_space);
+}
+
+TEST_CASE("niche: user enum with spare values") {
+  rd::expected<spare_enum, small_enum> e{spare_enum::two};
+  REQUIRE(e.has_value());
+  REQUIRE(*e == spare_enum::two);
+  e = rd::unexpected(small_enum::first);
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == small_enum::first);
+}
+
+TEST_CASE("niche: in the error") {
+  rd::expected<small_enum, spare_enum> e{small_enum::second};
+  REQUIRE(e.has_value());
+  REQUIRE(*e == small_enum::second);
+  e = rd::unexpected(spare_enum::one);
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == spare_enum::one);
+  rd::expected<small_enum, spare_enum> other{small_enum::first};
+  swap(e, other);
+  REQUIRE(e.has_value());
+  REQUIRE(*e == small_enum::first);
+  REQUIRE(other.error() == spare_enum::one);
+  other.emplace(small_enum::second);
+  REQUIRE(other == small_enum::second);
+}
+
+TEST_CASE("niche: in the error of void expected") {
+  rd::expected<void, spare_enum> e;
+  REQUIRE(e.has_value());
+  e = rd::unexpected(spare_enum::two);
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == spare_enum::two);
+  rd::expected<void, spare_enum> copy = e;
+  REQUIRE(copy == e);
+  e.emplace();
+  REQUIRE(e);
+  swap(e, copy);
+  REQUIRE(!e);
+  REQUIRE(copy);
+}
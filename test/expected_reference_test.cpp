@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <system_error>
+
+#include "test_include.hpp"
+
+namespace {
+struct record {
+  int id;
+  std::string name;
+};
+
+struct derived_record : record {};
+
+using lookup = rd::expected<record&, std::errc>;
+}  // namespace
+
+template <>
+struct rd::niche_traits<record*> : rd::pointer_niche<record> {};
+
+static_assert(!rd::detail::niche_supported ||
+              sizeof(lookup) == sizeof(record*));
+static_assert(sizeof(rd::expected<char&, std::errc>) ==
+              sizeof(rd::expected<char*, std::errc>));
+static_assert(std::is_trivially_copyable_v<lookup>);
+static_assert(rd::is_trivially_relocatable_v<lookup>);
+static_assert(std::is_constructible_v<lookup, record&>);
+static_assert(std::is_constructible_v<lookup, derived_record&>);
+static_assert(!std::is_constructible_v<lookup, record const&>);
+static_assert(!std::is_constructible_v<lookup, record&&>);
+static_assert(!std::is_constructible_v<rd::expected<record const&, int>,
+                                       record const&&>);
+static_assert(!std::is_default_constructible_v<lookup>);
+
+TEST_CASE("reference: refers to the object") {
+  record r{1, "one"};
+  lookup e = r;
+  REQUIRE(e.has_value());
+  REQUIRE(&*e == &r);
+  REQUIRE(&e.value() == &r);
+  REQUIRE(e->name == "one");
+  e->id = 2;
+  REQUIRE(r.id == 2);
+}
+
+TEST_CASE("reference: const expected still refers to non const object") {
+  record r{1, "one"};
+  lookup const e{std::in_place, r};
+  e->id = 3;
+  REQUIRE(r.id == 3);
+}
+
+TEST_CASE("reference: error") {
+  lookup e = rd::unexpected(std::errc::invalid_argument);
+  REQUIRE_FALSE(e.has_value());
+  REQUIRE(e.error() == std::errc::invalid_argument);
+  REQUIRE(e == rd::unexpected(std::errc::invalid_argument));
+  REQUIRE_THROWS_AS(e.value(), rd::bad_expected_access<std::errc>);
+}
+
+TEST_CASE("reference: heap error") {
+  rd::expected<record&, std::string> e{rd::unexpect, "missing"};
+  REQUIRE(e.error() == "missing");
+  auto moved = std::move(e).error();
+  REQUIRE(moved == "missing");
+}
+
+TEST_CASE("reference: assignment rebinds") {
+  record a{1, "a"};
+  record b{2, "b"};
+  lookup e = a;
+  e = b;
+  REQUIRE(&*e == &b);
+  REQUIRE(a.name == "a");
+  e = rd::unexpected(std::errc::io_error);
+  REQUIRE(e.error() == std::errc::io_error);
+  e.emplace(a);
+  REQUIRE(&*e == &a);
+  lookup other = b;
+  e = other;
+  REQUIRE(&*e == &b);
+}
+
+TEST_CASE("reference: converting") {
+  derived_record d{};
+  rd::expected<derived_record&, std::errc> e = d;
+  rd::expected<record const&, std::errc> c = e;
+  REQUIRE(&*c == &d);
+  rd::expected<derived_record&, std::errc> err{rd::unexpect,
+                                               std::errc::io_error};
+  rd::expected<record const&, std::errc> c2 = err;
+  REQUIRE(c2.error() == std::errc::io_error);
+
+  rd::expected<record, std::errc> copy = e;
+  REQUIRE(copy->id == d.id);
+}
+
+TEST_CASE("reference: value_or copies") {
+  record r{1, "one"};
+  lookup e = rd::unexpected(std::errc::io_error);
+  REQUIRE(e.value_or(r).name == "one");
+  e = r;
+  REQUIRE(e.value_or(record{2, "two"}).id == 1);
+}
+
+TEST_CASE("reference: swap") {
+  record r{1, "one"};
+  lookup a = r;
+  lookup b = rd::unexpected(std::errc::io_error);
+  swap(a, b);
+  REQUIRE(&*b == &r);
+  REQUIRE(a.error() == std::errc::io_error);
+}
+
+TEST_CASE("reference: monadic operations pass the reference") {
+  record r{1, "one"};
+  lookup e = r;
+  auto name = [](record& x) -> rd::expected<std::string&, std::errc> {
+    return x.name;
+  };
+  REQUIRE(&*e.and_then(name) == &r.name);
+  REQUIRE(&*std::move(e).and_then(name) == &r.name);
+  REQUIRE(e.transform([](record& x) { return &x; }).value() == &r);
+  REQUIRE(std::as_const(e).transform([](record& x) { return x.id; }) == 1);
+  REQUIRE(&*e.or_else([](std::errc) { return lookup(rd::unexpect); }) == &r);
+  REQUIRE(&*e.transform_error([](std::errc) { return 0; }) == &r);
+  e.transform([](record& x) { x.id = 5; });
+  REQUIRE(r.id == 5);
+}
+
+TEST_CASE("reference: monadic operations on error") {
+  record fallback{0, "fallback"};
+  lookup e = rd::unexpected(std::errc::io_error);
+  auto fail = [](record&) -> lookup {
+    return rd::unexpected(std::errc::invalid_argument);
+  };
+  REQUIRE(e.and_then(fail).error() == std::errc::io_error);
+  REQUIRE(e.transform([](record& x) { return x.id; }).error() ==
+          std::errc::io_error);
+  REQUIRE(&*e.or_else([&](std::errc) -> lookup { return fallback; }) ==
+          &fallback);
+  REQUIRE(e.transform_error([](std::errc c) { return static_cast<int>(c); })
+              .error() == static_cast<int>(std::errc::io_error));
+  bool called = false;
+  auto same = e.or_else([&](std::errc) { called = true; });
+  REQUIRE(called);
+  REQUIRE(same.error() == std::errc::io_error);
+}
+
+TEST_CASE("reference: equality") {
+  record a{1, "a"};
+  record b{1, "a"};
+  rd::expected<int&, int> x = a.id;
+  rd::expected<int&, int> y = b.id;
+  REQUIRE(x == y);
+  REQUIRE(x == 1);
+  REQUIRE(x != 2);
+  REQUIRE(x == rd::expected<int, int>(1));
+  REQUIRE(x != rd::expected<int, int>(rd::unexpect, 1));
+}
@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <memory>
+#include <stdexcept>
+
+#include "test_include.hpp"
+
+namespace {
+// Counts moves so tests can tell relocation from move construction.
+struct relocatable {
+  inline static int moves = 0;
+
+  explicit relocatable(int v) : p(std::make_unique<int>(v)) {}
+  relocatable(relocatable&& other) noexcept : p(std::move(other.p)) {
+    ++moves;
+  }
+  auto operator=(relocatable&& other) noexcept -> relocatable& {
+    p = std::move(other.p);
+    ++moves;
+    return *this;
+  }
+  ~relocatable() = default;
+
+  std::unique_ptr<int> p;
+};
+
+#ifdef __cpp_exceptions
+struct throwing {
+  throwing(int v) : val(v) {  // NOLINT
+    if (v < 0) throw std::runtime_error("negative");
+  }
+  throwing(throwing const&) = default;
+  throwing(throwing&& other) noexcept(false) : val(other.val) {}
+  auto operator=(throwing const&) -> throwing& = default;
+  auto operator=(throwing&&) noexcept(false) -> throwing& = default;
+  ~throwing() = default;
+
+  int val;
+};
+#endif
+}  // namespace
+
+template <>
+struct rd::is_trivially_relocatable<relocatable> : std::true_type {};
+
+static_assert(rd::is_trivially_relocatable_v<int>);
+static_assert(rd::is_trivially_relocatable_v<std::unique_ptr<int>>);
+static_assert(!rd::is_trivially_relocatable_v<std::string>);
+static_assert(rd::is_trivially_relocatable_v<rd::expected<relocatable, int>>);
+static_assert(rd::is_trivially_relocatable_v<rd::expected<void, relocatable>>);
+static_assert(!rd::is_trivially_relocatable_v<rd::expected<relocatable,
+                                                            std::string>>);
+
+TEST_CASE("relocate_at: trivially relocatable object is not moved") {
+  relocatable::moves = 0;
+  alignas(relocatable) unsigned char buf[sizeof(relocatable)];
+  auto* src = new (buf) relocatable(3);  // NOLINT
+  relocatable dst_storage(0);
+  std::destroy_at(&dst_storage);
+  auto* dst = rd::relocate_at(src, &dst_storage);
+  REQUIRE(*dst->p == 3);
+  REQUIRE(relocatable::moves == 0);
+}
+
+TEST_CASE("relocate_at: other objects are moved and destroyed") {
+  std::string src_storage = "relocate me, I am too long for small strings";
+  alignas(std::string) unsigned char buf[sizeof(std::string)];
+  auto* dst = rd::relocate_at(&src_storage,
+                              reinterpret_cast<std::string*>(buf));  // NOLINT
+  REQUIRE(*dst == "relocate me, I am too long for small strings");
+  std::destroy_at(dst);
+  std::construct_at(&src_storage);
+}
+
+TEST_CASE("relocation: swap of mixed states") {
+  relocatable::moves = 0;
+  rd::expected<relocatable, relocatable> lhs{std::in_place, 1};
+  rd::expected<relocatable, relocatable> rhs{rd::unexpect, 2};
+  swap(lhs, rhs);
+  REQUIRE(!lhs.has_value());
+  REQUIRE(*lhs.error().p == 2);
+  REQUIRE(rhs.has_value());
+  REQUIRE(*rhs->p == 1);
+  swap(lhs, rhs);
+  REQUIRE(lhs.has_value());
+  REQUIRE(*lhs->p == 1);
+  REQUIRE(*rhs.error().p == 2);
+  REQUIRE(relocatable::moves == 0);
+}
+
+TEST_CASE("relocation: state changing assignment") {
+  relocatable::moves = 0;
+  rd::expected<relocatable, std::string> e{std::in_place, 1};
+  e = rd::unexpected<std::string>("error");
+  REQUIRE(!e.has_value());
+  REQUIRE(e.error() == "error");
+  REQUIRE(relocatable::moves == 0);
+}
+
+#ifdef __cpp_exceptions
+TEST_CASE("relocation: failed assignment restores the old error") {
+  relocatable::moves = 0;
+  rd::expected<throwing, relocatable> e{rd::unexpect, 7};
+  REQUIRE_THROWS(e = -1);
+  REQUIRE(!e.has_value());
+  REQUIRE(*e.error().p == 7);
+  REQUIRE(relocatable::moves == 0);
+  e = 1;
+  REQUIRE(e.has_value());
+  REQUIRE(e->val == 1);
+}
+#endif
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include "alloc_counter.hpp"
 #include "test_include.hpp"
 
 TEST_CASE("swap: lhs has value, rhs has value") {
@@ -67,3 +68,22 @@ TEST_CASE("swap: lhs has error, rhs has error") {
   REQUIRE(lhs.error() == "rhs");
   REQUIRE(rhs.error() == "lhs");
 }
+
+TEST_CASE("swap doesn't allocate in any state") {
+  using result = rd::expected<std::string, std::string>;
+  auto const v = alloc_counter::long_string('v');
+  auto const e = alloc_counter::long_string('e');
+  result val1{v};
+  result val2{v};
+  result err1{rd::unexpect, e};
+  result err2{rd::unexpect, e};
+  REQUIRE_NO_ALLOC {
+    using std::swap;
+    swap(val1, val2);
+    swap(err1, err2);
+    swap(val1, err1);
+    swap(err1, val1);
+  }
+  REQUIRE(*val1 == v);
+  REQUIRE(err1.error() == e);
+}
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include "alloc_counter.hpp"
 #include "test_include.hpp"
 
 TEST_CASE("copy assignment: lhs has value, rhs has value") {
@@ -115,3 +116,24 @@ TEST_CASE("unexpected assignment: lhs has error MOVE") {
   REQUIRE(!lhs.has_value());
   REQUIRE(lhs.error() == "error");
 }
+
+TEST_CASE("move assignment doesn't allocate in any state") {
+  using result = rd::expected<void, std::string>;
+  auto const e = alloc_counter::long_string('e');
+  result value_to_error;
+  result error_to_error{rd::unexpect, "error"};
+  result error_to_value{rd::unexpect, e};
+  result errors[] = {result{rd::unexpect, e}, result{rd::unexpect, e}};
+  auto u = rd::unexpected(e);
+  result value_to_unexpected;
+  REQUIRE_NO_ALLOC {
+    value_to_error = std::move(errors[0]);
+    error_to_error = std::move(errors[1]);
+    error_to_value = result();
+    value_to_unexpected = std::move(u);
+  }
+  REQUIRE(value_to_error.error() == e);
+  REQUIRE(error_to_error.error() == e);
+  REQUIRE(error_to_value.has_value());
+  REQUIRE(value_to_unexpected.error() == e);
+}
@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include "alloc_counter.hpp"
 #include "test_include.hpp"
 
 auto create_expected_success() { return rd::expected<int, int>(2); }
@@ -277,3 +278,21 @@ TEST_CASE("transform_error && with error") {
   REQUIRE(!post.has_value());
   REQUIRE(post.error() == 3);
 }
+
+TEST_CASE("rvalue monadic chains don't allocate") {
+  using result = rd::expected<void, std::string>;
+  auto const e = alloc_counter::long_string('e');
+  result err{rd::unexpect, e};
+  auto identity = [](std::string s) { return s; };
+  result post;
+  REQUIRE_NO_ALLOC {
+    post = std::move(err)
+               .and_then([] { return result(); })
+               .transform([] {})
+               .transform_error(identity)
+               .or_else([](std::string s) {
+                 return result(rd::unexpect, std::move(s));
+               });
+  }
+  REQUIRE(post.error() == e);
+}
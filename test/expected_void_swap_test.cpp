@@ -22,6 +22,7 @@
  * SOFTWARE.
  */
 
+#include "alloc_counter.hpp"
 #include "test_include.hpp"
 
 TEST_CASE("swap: lhs has value, rhs has value") {
@@ -63,3 +64,19 @@ TEST_CASE("swap: lhs has error, rhs has error") {
   REQUIRE(lhs.error() == "rhs");
   REQUIRE(rhs.error() == "lhs");
 }
+
+TEST_CASE("swap doesn't allocate in any state") {
+  using result = rd::expected<void, std::string>;
+  auto const e = alloc_counter::long_string('e');
+  result val;
+  result err1{rd::unexpect, e};
+  result err2{rd::unexpect, e};
+  REQUIRE_NO_ALLOC {
+    using std::swap;
+    swap(err1, err2);
+    swap(val, err1);
+    swap(val, err1);
+  }
+  REQUIRE(val.has_value());
+  REQUIRE(err1.error() == e);
+}
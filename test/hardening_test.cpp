@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks run in the verbose mode here, while the other test files use the
+// default mode. Each mode has its own inline namespace, so the two don't
+// clash.
+#define RD_EXPECTED_HARDENING 2
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+
+#include "death_test.hpp"
+#include "rd/shared_error.hpp"
+#include "test_include.hpp"
+
+namespace {
+struct value {
+  int v;
+};
+
+struct error {
+  int code;
+};
+
+char const* expected_violation = "";  // NOLINT
+
+void exit_on_violation(char const* violation) {
+  std::_Exit(std::strcmp(violation, expected_violation) == 0 ? 4 : 5);
+}
+
+constexpr auto constant_access() -> int {
+  rd::expected<value, error> v = value{1};
+  rd::expected<value, error> e = rd::unexpected(error{2});
+  return (*v).v + v->v + e.error().code;
+}
+
+#if HAS_DEATH_TESTS
+// Wait status of a child in which f violates a precondition.
+template <class F>
+auto violate(char const* violation, F f) -> int {
+  expected_violation = violation;
+  return run_in_child([&] {
+    rd::set_precondition_handler(exit_on_violation);
+    f();
+  });
+}
+
+auto reported(int status) -> bool {
+  return WIFEXITED(status) && WEXITSTATUS(status) == 4;
+}
+#endif
+}  // namespace
+
+static_assert(constant_access() == 4);
+static_assert(std::is_same_v<rd::expected<int, int>,
+                             rd::hardening_2::expected<int, int>>);
+
+TEST_CASE("hardening: installing handlers") {
+  auto const previous = rd::set_precondition_handler(exit_on_violation);
+  REQUIRE(previous == rd::log_and_abort_on_precondition_violation);
+  REQUIRE(rd::get_precondition_handler() == exit_on_violation);
+  REQUIRE(rd::set_precondition_handler(nullptr) == exit_on_violation);
+  REQUIRE(rd::get_precondition_handler() ==
+          rd::log_and_abort_on_precondition_violation);
+}
+
+TEST_CASE("hardening: accesses in the right state pass") {
+  rd::expected<value, error> v = value{1};
+  rd::expected<value, error> e = rd::unexpected(error{2});
+  REQUIRE((*v).v == 1);
+  REQUIRE(v->v == 1);
+  REQUIRE(std::move(v)->v == 1);
+  REQUIRE(e.error().code == 2);
+
+  value x{3};
+  rd::expected<value&, error> r = x;
+  REQUIRE(r->v == 3);
+
+  rd::expected<void, error> ok;
+  *ok;
+  rd::expected<void, error> failed = rd::unexpected(error{4});
+  REQUIRE(failed.error().code == 4);
+}
+
+#if HAS_DEATH_TESTS
+TEST_CASE("hardening: violations are reported") {
+  rd::expected<value, error> const v = value{1};
+  rd::expected<value, error> const e = rd::unexpected(error{2});
+
+  REQUIRE(reported(violate("operator* on an expected without a value",
+                           [&] { static_cast<void>((*e).v); })));
+  REQUIRE(reported(violate("operator* on an expected without a value",
+                           [&] { static_cast<void>((*std::move(e)).v); })));
+  REQUIRE(reported(violate("operator-> on an expected without a value",
+                           [&] { static_cast<void>(e->v); })));
+  REQUIRE(reported(violate("error() on an expected with a value",
+                           [&] { static_cast<void>(v.error().code); })));
+
+  rd::expected<void, error> const ok;
+  REQUIRE(reported(violate("error() on an expected with a value",
+                           [&] { static_cast<void>(ok.error().code); })));
+  rd::expected<void, error> const failed = rd::unexpected(error{3});
+  REQUIRE(reported(violate("operator* on an expected without a value",
+                           [&] { *failed; })));
+
+  rd::expected<value&, error> const r = rd::unexpected(error{4});
+  REQUIRE(reported(violate("operator-> on an expected without a value",
+                           [&] { static_cast<void>(r->v); })));
+}
+
+TEST_CASE("hardening: shared_error violations are reported") {
+  rd::shared_error<int> a{std::in_place, 1};
+  rd::shared_error<int> const b = a;
+  rd::shared_error<int> const moved = std::move(a);
+  REQUIRE(*b == 1);
+  REQUIRE(b.use_count() == 2);
+
+  REQUIRE(reported(violate("operator* on a valueless shared_error",
+                           [&] { static_cast<void>(*a); })));  // NOLINT
+  REQUIRE(reported(violate("operator-> on a valueless shared_error",
+                           [&] { static_cast<void>(a.operator->()); })));
+  REQUIRE(reported(violate("use_count() on a valueless shared_error",
+                           [&] { static_cast<void>(a.use_count()); })));
+  REQUIRE(reported(violate("message() on a valueless shared_error",
+                           [&] { static_cast<void>(a.message()); })));
+  REQUIRE(reported(violate("operator== on a valueless shared_error",
+                           [&] { static_cast<void>(a == b); })));
+  REQUIRE(reported(violate("operator== on a valueless shared_error",
+                           [&] { static_cast<void>(b == a); })));
+  REQUIRE(reported(violate("operator== on a valueless shared_error",
+                           [&] { static_cast<void>(a == 1); })));
+}
+
+TEST_CASE("hardening: the program is aborted by default") {
+  int const status = run_in_child([] {
+    rd::expected<value, error> e = rd::unexpected(error{2});
+    static_cast<void>(e->v);
+  });
+  REQUIRE(WIFSIGNALED(status));
+  REQUIRE(WTERMSIG(status) == SIGABRT);
+}
+#endif
@@ -0,0 +1,65 @@
+# MIT License
+# 
+# Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+# Builds the rd.expected module and SOURCE, which imports it, with GCC's
+# -fmodules-ts and runs the result. This doesn't need CMake's support for
+# modules, so it runs wherever GCC 11 or newer does.
+# Run as
+#   cmake -DCOMPILER=<g++> -DINTERFACE=<expected.cppm> -DSOURCE=<smoke_test.cpp>
+#         -DINCLUDE=<include dir> -DWORK_DIR=<dir> -P check_module.cmake
+
+# The standard headers the headers include must all be in the global module
+# fragment of the interface, or they'd be declared in the module's purview.
+file(READ ${INTERFACE} interface)
+file(GLOB headers ${INCLUDE}/rd/*.hpp)
+foreach(header ${headers})
+  file(STRINGS ${header} includes REGEX "^#include <[^>]+>")
+  foreach(include ${includes})
+    string(FIND "${interface}" "${include}\n" found)
+    if(found EQUAL -1)
+      message(FATAL_ERROR "${INTERFACE} lacks ${include}, needed by ${header}")
+    endif()
+  endforeach()
+endforeach()
+
+# Runs a step of the build in WORK_DIR, where GCC keeps gcm.cache.
+function(run_step what)
+  execute_process(
+    COMMAND ${ARGN}
+    WORKING_DIRECTORY ${WORK_DIR}
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE output)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${what} failed:\n${output}")
+  endif()
+endfunction()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+run_step("building the module" ${COMPILER} -std=c++20 -fmodules-ts
+         -I${INCLUDE} -c -x c++ ${INTERFACE} -o expected.o)
+run_step("building ${SOURCE}" ${COMPILER} -std=c++20 -fmodules-ts -c ${SOURCE}
+         -o smoke_test.o)
+run_step("linking" ${COMPILER} smoke_test.o expected.o -o smoke_test)
+run_step("running smoke_test" ${WORK_DIR}/smoke_test)
@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <doctest/doctest.h>
+
+#include <string>
+
+import rd.expected;
+
+namespace {
+auto parse_digit(char c) -> rd::expected<int, std::string> {
+  if (c < '0' || c > '9') {
+    return rd::unexpected(std::string("not a digit"));
+  }
+  return c - '0';
+}
+}  // namespace
+
+TEST_CASE("module: value and error") {
+  REQUIRE(parse_digit('7') == 7);
+  REQUIRE(parse_digit('x').error() == "not a digit");
+}
+
+TEST_CASE("module: monadic operations") {
+  auto doubled = parse_digit('4').transform([](int x) { return 2 * x; });
+  REQUIRE(*doubled == 8);
+  auto recovered = parse_digit('x').or_else(
+      [](std::string const&) -> rd::expected<int, std::string> { return 0; });
+  REQUIRE(*recovered == 0);
+  REQUIRE(parse_digit('3').and_then(parse_digit).error() == "not a digit");
+}
+
+TEST_CASE("module: void, references and swap") {
+  rd::expected<void, int> v{rd::unexpect, 1};
+  rd::expected<void, int> w;
+  swap(v, w);
+  REQUIRE(v.has_value());
+  REQUIRE(w.error() == 1);
+
+  int x = 1;
+  rd::expected<int&, int> ref{x};
+  *ref = 2;
+  REQUIRE(x == 2);
+}
+
+TEST_CASE("module: traits and handlers") {
+  static_assert(rd::is_trivially_relocatable_v<rd::expected<int, int>>);
+  static_assert(!rd::detail::niche_supported ||
+                sizeof(rd::expected<int*, rd::unexpect_t>) == sizeof(int*));
+  auto previous = rd::set_bad_access_handler(rd::terminate_on_bad_access);
+  REQUIRE(rd::get_bad_access_handler() == &rd::terminate_on_bad_access);
+  rd::set_bad_access_handler(previous);
+}
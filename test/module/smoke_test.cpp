@@ -0,0 +1,69 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Imports rd.expected with nothing else in the way: no test framework, no
+// standard headers but <new>, which GCC 12 needs for the placement new in
+// std::construct_at. Returns 0 when expected works through the import.
+
+#include <new>
+
+import rd.expected;
+
+namespace {
+enum class parse_error { not_a_digit };
+
+auto parse_digit(char c) -> rd::expected<int, parse_error> {
+  if (c < '0' || c > '9') {
+    return rd::unexpected(parse_error::not_a_digit);
+  }
+  return c - '0';
+}
+
+auto check_value() -> bool {
+  auto digit = parse_digit('7');
+  auto doubled = digit.transform([](int x) { return 2 * x; });
+  return digit.has_value() && *digit == 7 && doubled == 14 &&
+         digit.value_or(0) == 7;
+}
+
+auto check_error() -> bool {
+  auto digit = parse_digit('x');
+  auto code = digit.transform_error(
+      [](parse_error e) { return static_cast<int>(e) + 1; });
+  return !digit.has_value() && digit.error() == parse_error::not_a_digit &&
+         digit == rd::unexpected(parse_error::not_a_digit) &&
+         code.error() == 1 && digit.value_or(-1) == -1;
+}
+
+auto check_void() -> bool {
+  rd::expected<void, int> failed{rd::unexpect, 1};
+  rd::expected<void, int> done;
+  swap(failed, done);
+  return failed.has_value() && done.error() == 1;
+}
+}  // namespace
+
+auto main() -> int {
+  return check_value() && check_error() && check_void() ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <utility>
+
+#include "alloc_counter.hpp"
+#include "rd/pipeline.hpp"
+#include "test_include.hpp"
+
+namespace {
+struct error {
+  int code;
+};
+
+auto halve(int x) -> rd::expected<int, error> {
+  if (x % 2 != 0) {
+    return rd::unexpected(error{x});
+  }
+  return x / 2;
+}
+
+auto check(int x) -> rd::expected<void, error> {
+  if (x < 0) {
+    return rd::unexpected(error{x});
+  }
+  return {};
+}
+
+auto describe(error e) -> std::string { return std::to_string(e.code); }
+
+struct pair {
+  int first;
+  int second;
+  [[nodiscard]] auto sum() const -> int { return first + second; }
+};
+
+// Counts the calls made to it.
+struct counted {
+  int* calls;
+  auto operator()(int x) const -> int {
+    ++*calls;
+    return x + 1;
+  }
+};
+}  // namespace
+
+TEST_CASE("pipeline with value, with successful stages") {
+  rd::expected<int, error> e{8};
+  rd::expected<std::string, error> r =
+      e | rd::then(halve) | rd::then(halve) |
+      rd::map([](int x) { return std::to_string(x); });
+  REQUIRE(r.has_value());
+  REQUIRE(*r == "2");
+}
+
+TEST_CASE("pipeline with value, with failed stage") {
+  int calls = 0;
+  rd::expected<int, error> e{6};
+  rd::expected<int, error> r =
+      e | rd::then(halve) | rd::then(halve) | rd::map(counted{&calls});
+  REQUIRE(!r.has_value());
+  REQUIRE(r.error().code == 3);
+  REQUIRE(calls == 0);
+}
+
+TEST_CASE("pipeline with error runs only map_error stages") {
+  int calls = 0;
+  rd::expected<int, error> e{rd::unexpect, error{5}};
+  rd::expected<int, std::string> r = e | rd::map(counted{&calls}) |
+                                     rd::then(halve) | rd::map_error(describe) |
+                                     rd::map(counted{&calls});
+  REQUIRE(!r.has_value());
+  REQUIRE(r.error() == "5");
+  REQUIRE(calls == 0);
+}
+
+TEST_CASE("pipeline map_error leaves value untouched") {
+  rd::expected<int, error> e{4};
+  rd::expected<int, std::string> r = e | rd::map_error(describe);
+  REQUIRE(r.has_value());
+  REQUIRE(*r == 4);
+}
+
+TEST_CASE("pipeline with void expected") {
+  rd::expected<void, error> e;
+  rd::expected<int, error> r = e | rd::map([] { return 3; });
+  REQUIRE(*r == 3);
+  rd::expected<void, error> v = (rd::expected<int, error>{-1} | rd::then(check))
+                                    .run();
+  REQUIRE(!v.has_value());
+  REQUIRE(v.error().code == -1);
+  int seen = 0;
+  rd::expected<void, error> w =
+      rd::expected<int, error>{2} | rd::map([&](int x) { seen = x; });
+  REQUIRE(w.has_value());
+  REQUIRE(seen == 2);
+}
+
+TEST_CASE("pipeline with rvalue source moves the value through") {
+  rd::expected<std::string, error> e{alloc_counter::long_string('a')};
+  rd::expected<std::size_t, error> r =
+      std::move(e) | rd::map([](std::string&& s) {
+        auto taken = std::move(s);
+        return taken.size();
+      });
+  REQUIRE(*r == 64);
+  REQUIRE(e->empty());  // NOLINT
+}
+
+TEST_CASE("pending pipeline keeps a temporary source alive") {
+  auto make = [] {
+    return rd::expected<std::string, error>{alloc_counter::long_string('a')};
+  };
+  auto p = make() | rd::map([](std::string&& s) { return s.size(); });
+  rd::expected<std::size_t, error> r = std::move(p);
+  REQUIRE(*r == 64);
+  auto q = make() | rd::map([](std::string const& s) { return s + "b"; }) |
+           rd::map([](std::string&& s) { return s.size(); });
+  REQUIRE(*std::move(q).run() == 65);
+}
+
+TEST_CASE("pipeline with member pointers") {
+  rd::expected<pair, error> e{pair{1, 2}};
+  rd::expected<int, error> first = e | rd::map(&pair::first);
+  rd::expected<int, error> sum = e | rd::map(&pair::sum);
+  REQUIRE(*first == 1);
+  REQUIRE(*sum == 3);
+}
+
+TEST_CASE("composed pipeline can be reused") {
+  auto const p = rd::then(halve) | rd::map([](int x) { return x * 3; }) |
+                 rd::map_error([](error e) { return e.code; });
+  auto ok = p(rd::expected<int, error>{4});
+  auto failed = p(rd::expected<int, error>{5});
+  REQUIRE(*ok == 6);
+  REQUIRE(failed.error() == 5);
+}
+
+TEST_CASE("pipeline is usable in constant expressions") {
+  constexpr rd::expected<int, int> r =
+      rd::expected<int, int>{2} | rd::map([](int x) { return x + 1; });
+  static_assert(r.has_value() && *r == 3);
+  constexpr auto p = rd::then([](int x) -> rd::expected<int, int> {
+    return rd::unexpected(x);
+  });
+  static_assert(p(rd::expected<int, int>{7}).error() == 7);
+}
+
+TEST_CASE("pipeline doesn't allocate") {
+  rd::expected<std::string, error> e{alloc_counter::long_string('a')};
+  REQUIRE_NO_ALLOC {
+    rd::expected<std::string, error> r =
+        std::move(e) | rd::map([](std::string&& s) { return std::move(s); }) |
+        rd::map_error([](error x) { return error{x.code + 1}; });
+    REQUIRE(r->size() == 64);
+  }
+}
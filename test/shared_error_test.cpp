@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "rd/shared_error.hpp"
+#include "test_include.hpp"
+
+namespace {
+using result = rd::expected<int, rd::shared_error<std::string>>;
+
+auto fail() -> result {
+  return rd::unexpected(alloc_counter::long_string('e'));
+}
+}  // namespace
+
+static_assert(sizeof(rd::shared_error<std::string>) == sizeof(void*));
+static_assert(sizeof(result) <= 2 * sizeof(void*));
+static_assert(rd::is_trivially_relocatable_v<result>);
+static_assert(
+    std::is_nothrow_copy_constructible_v<rd::shared_error<std::string>>);
+static_assert(std::is_nothrow_move_constructible_v<result>);
+
+TEST_CASE("shared_error: construction") {
+  rd::shared_error<std::string> a{std::in_place, 3, 'a'};
+  REQUIRE(*a == "aaa");
+  REQUIRE(a->size() == 3);
+  REQUIRE(a.use_count() == 1);
+  REQUIRE_FALSE(a.valueless_after_move());
+
+  rd::shared_error<std::string> b = std::string("text");
+  REQUIRE(*b == "text");
+}
+
+TEST_CASE("shared_error: copies share the error") {
+  rd::shared_error<std::string> a{std::in_place, "a"};
+  alloc_counter::scope scope;
+  rd::shared_error<std::string> b = a;
+  REQUIRE(&*a == &*b);
+  REQUIRE(a.use_count() == 2);
+  {
+    rd::shared_error<std::string> c = b;
+    REQUIRE(a.use_count() == 3);
+  }
+  REQUIRE(a.use_count() == 2);
+  REQUIRE(scope.count() == 0);
+}
+
+TEST_CASE("shared_error: assignment") {
+  rd::shared_error<std::string> a{std::in_place, "a"};
+  rd::shared_error<std::string> b{std::in_place, "b"};
+  a = b;
+  REQUIRE(&*a == &*b);
+  REQUIRE(b.use_count() == 2);
+  a = a;  // NOLINT
+  REQUIRE(b.use_count() == 2);
+  rd::shared_error<std::string> c = std::move(a);
+  REQUIRE(a.valueless_after_move());  // NOLINT
+  REQUIRE(c.use_count() == 2);
+  a = c;
+  REQUIRE(c.use_count() == 3);
+}
+
+TEST_CASE("shared_error: message and equality") {
+  rd::shared_error<std::string> a{std::in_place, "a"};
+  rd::local_shared_error<std::string> b{std::in_place, "a"};
+  REQUIRE(a.message() == "a");
+  REQUIRE(a == b);
+  REQUIRE(a == std::string("a"));
+  REQUIRE(std::string("b") != a);
+}
+
+TEST_CASE("shared_error: propagating from an lvalue doesn't copy the error") {
+  result const err = fail();
+  REQUIRE_NO_ALLOC {
+    auto next = err.and_then([](int x) -> result { return x + 1; });
+    auto mapped = err.transform([](int x) { return x * 2; });
+    REQUIRE(&*next.error() == &*err.error());
+    REQUIRE(&*mapped.error() == &*err.error());
+    REQUIRE(err.error().use_count() == 3);
+  }
+  REQUIRE(err.error().use_count() == 1);
+}
+
+TEST_CASE("shared_error: as error of expected") {
+  result err = rd::unexpected(std::string("failed"));
+  REQUIRE(err.error() == std::string("failed"));
+  REQUIRE(err == rd::unexpected(std::string("failed")));
+  result failed{rd::unexpect, "failed"};
+  REQUIRE(failed == err);
+  result ok = 1;
+  REQUIRE(*ok == 1);
+}
+
+TEST_CASE("shared_error: copies on other threads") {
+  result const err = fail();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j) {
+        result copy = err;
+        (void)copy;
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  REQUIRE(err.error().use_count() == 1);
+}
+
+TEST_CASE("shared_error: allocates from the current arena") {
+  std::pmr::monotonic_buffer_resource upstream;
+  rd::error_arena arena(&upstream);
+  rd::local_shared_error<std::pmr::string> e{std::in_place,
+                                            alloc_counter::long_string('x')};
+  REQUIRE(e->get_allocator().resource() == &arena);
+}
@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 Rishabh Dwivedi<rishabhdwivedi17@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cerrno>
+#include <future>
+#include <system_error>
+
+#include "rd/status_code.hpp"
+#include "test_include.hpp"
+
+namespace {
+enum class parse_error { empty = 1, overflow };
+
+struct parse_domain_t final : rd::status_domain {
+  [[nodiscard]] auto name() const noexcept -> std::string_view override {
+    return "parse";
+  }
+
+  [[nodiscard]] auto message(int value) const -> std::string override {
+    switch (static_cast<parse_error>(value)) {
+      case parse_error::empty:
+        return "empty input";
+      case parse_error::overflow:
+        return "number too large";
+    }
+    return "unknown parse error";
+  }
+};
+
+constexpr parse_domain_t parse_domain{};
+
+using result = rd::expected<int, rd::status_code>;
+}  // namespace
+
+static_assert(std::is_trivially_copyable_v<rd::status_code>);
+static_assert(sizeof(rd::status_code) == 2 * sizeof(void*));
+static_assert(std::is_trivially_copyable_v<result>);
+// Where expected can use niches at all.
+static_assert(!rd::detail::niche_supported ||
+              sizeof(result) == sizeof(rd::status_code));
+static_assert(!rd::detail::niche_supported ||
+              sizeof(rd::expected<void, rd::status_code>) ==
+                  sizeof(rd::status_code));
+static_assert(rd::status_code(std::errc::io_error).value() ==
+              static_cast<int>(std::errc::io_error));
+static_assert(rd::status_code(parse_domain, 1) ==
+              rd::status_code(parse_domain, 1));
+static_assert(rd::status_code(parse_domain, 1) !=
+              rd::status_code(rd::errc_domain, 1));
+static_assert([] {
+  result e = 3;
+  bool ok = e.has_value() && *e == 3;
+  e = rd::unexpected(rd::status_code(parse_domain, 1));
+  return ok && !e.has_value() && e.error() == rd::status_code(parse_domain, 1);
+}());
+
+constexpr result constant_result = 7;
+
+TEST_CASE("status_code: errc") {
+  rd::status_code code = std::errc::no_such_file_or_directory;
+  REQUIRE(&code.domain() == &rd::errc_domain);
+  REQUIRE(code.domain().name() == "errc");
+  REQUIRE(code == std::errc::no_such_file_or_directory);
+  REQUIRE(code.message() ==
+          std::make_error_code(std::errc::no_such_file_or_directory).message());
+}
+
+TEST_CASE("status_code: user domain") {
+  rd::status_code code{parse_domain, static_cast<int>(parse_error::overflow)};
+  REQUIRE(code.domain().name() == "parse");
+  REQUIRE(code.message() == "number too large");
+}
+
+TEST_CASE("status_code: from error_code") {
+  rd::status_code generic = std::make_error_code(std::errc::timed_out);
+  REQUIRE(generic == std::errc::timed_out);
+
+  rd::status_code system = std::error_code(EACCES, std::system_category());
+  REQUIRE(&system.domain() == &rd::errno_domain);
+  REQUIRE(system.value() == EACCES);
+
+  auto future_code = std::make_error_code(std::future_errc::no_state);
+  rd::status_code future = future_code;
+  REQUIRE(future.domain().name() == future_code.category().name());
+  REQUIRE(future.message() == future_code.message());
+  rd::status_code again = future_code;
+  REQUIRE(&again.domain() == &future.domain());
+  REQUIRE(again == future);
+}
+
+TEST_CASE("status_code: error of expected") {
+  auto parse = [](std::string_view s) -> result {
+    if (s.empty()) {
+      return rd::unexpected(
+          rd::status_code(parse_domain, static_cast<int>(parse_error::empty)));
+    }
+    return static_cast<int>(s.size());
+  };
+  REQUIRE(parse("abc") == 3);
+  auto failed = parse("");
+  REQUIRE(!failed.has_value());
+  REQUIRE(failed.error().message() == "empty input");
+
+  result e = rd::unexpected(std::errc::io_error);
+  REQUIRE(e == rd::unexpected(std::errc::io_error));
+  e = 4;
+  REQUIRE(e.has_value());
+  REQUIRE(*e == 4);
+  auto moved = std::move(e).and_then([](int) -> result {
+    return rd::unexpected(std::errc::invalid_argument);
+  });
+  REQUIRE(moved.error() == std::errc::invalid_argument);
+}
+
+TEST_CASE("status_code: constant initialized expected") {
+  REQUIRE(constant_result.has_value());
+  REQUIRE(*constant_result == 7);
+}